@@ -0,0 +1,46 @@
+#include <MobaTools.h>
+/* Demo for synchronized servo movements
+   Four servos of a level crossing gate are moved as a group. With MoToServoGroup
+   all servos start at the same time and reach their target at the same time, even if
+   the way to go is different for each servo.
+   The gates are closed while the button is pressed.
+   The sketch does not block and can be extended to do other tasks.
+*/
+
+// The button must be connected between pin and Gnd
+const int buttonPin = A2;
+const byte servoPins[] = { 3, 4, 5, 6 };
+
+// positions of the gates ( the gates on the other side of the track are mounted mirrored )
+const uint16_t gatesOpen[]   = { 90, 90, 90, 90 };
+const uint16_t gatesClosed[] = {  5, 175, 10, 170 };
+const uint16_t moveTime = 4000;     // time in ms to open/close the gates
+
+MoToServo gate1, gate2, gate3, gate4;
+MoToServo *gates[] = { &gate1, &gate2, &gate3, &gate4 };
+MoToServoGroup crossingGates( gates, 4 );
+
+bool closed = false;
+
+void setup() {
+  pinMode(buttonPin, INPUT_PULLUP);
+  for ( byte i = 0; i < 4; i++ ) {
+    gates[i]->attach( servoPins[i] );
+    gates[i]->setEasing( EASE_INOUT );  // smooth start and stop
+    gates[i]->write( gatesOpen[i] );
+  }
+}
+
+void loop() {
+  bool buttonPressed = !digitalRead(buttonPin);    // 'buttonPressed is 'true' if pin is LOW
+
+  if ( buttonPressed && !closed ) {
+    crossingGates.moveTo( gatesClosed, moveTime );
+    closed = true;
+  }
+  if ( !buttonPressed && closed && !crossingGates.moving() ) {
+    // open the gates only, when they have been closed completely
+    crossingGates.moveTo( gatesOpen, moveTime );
+    closed = false;
+  }
+}
@@ -0,0 +1,45 @@
+#include <MobaTools.h>
+/* Demo for servo keyframe sequences ( not for ESP8266/ESP32 )
+   A crane is moved by three servos: turning, lifting the boom and the hook.
+   The movements are stored as keyframes in flash and played in the servo interrupt.
+   loop() only starts the sequence when the button is pressed, it is free for other tasks.
+*/
+
+// The button must be connected between pin and Gnd
+const int buttonPin = A2;
+const byte turnPin = 3, boomPin = 4, hookPin = 5;
+
+MoToServo turn, boom, hook;
+MoToServo *crane[] = { &turn, &boom, &hook };
+
+// SERVO_KEYFRAME( servo index, target, move time (ms), easing, wait time until next keyframe (ms) )
+// Keyframes with a wait time of 0 start together with the next keyframe
+const servoKeyframe_t craneMoves[] PROGMEM = {
+  SERVO_KEYFRAME( 2, 120, 1500, EASE_OUT,    1800 ),  // lower the hook
+  SERVO_KEYFRAME( 2,  40, 1500, EASE_INOUT,  1800 ),  // lift the load
+  SERVO_KEYFRAME( 0, 160, 3000, EASE_INOUT,     0 ),  // turn and raise the boom at the same time
+  SERVO_KEYFRAME( 1, 110, 3000, EASE_INOUT,  3500 ),
+  SERVO_KEYFRAME( 2, 120, 1500, EASE_OUT,    2500 ),  // put down the load
+  SERVO_KEYFRAME( 2,  40, 1000, EASE_LINEAR, 1200 ),
+  SERVO_KEYFRAME( 0,  20, 3000, EASE_INOUT,     0 ),  // back to the start position
+  SERVO_KEYFRAME( 1,  70, 3000, EASE_INOUT,  3000 ),
+  SERVO_SEQEND
+};
+
+MoToServoSequence craneSequence( crane, 3, craneMoves );
+
+void setup() {
+  pinMode(buttonPin, INPUT_PULLUP);
+  turn.attach( turnPin );
+  boom.attach( boomPin );
+  hook.attach( hookPin );
+  turn.write( 20 );
+  boom.write( 70 );
+  hook.write( 40 );
+}
+
+void loop() {
+  if ( !digitalRead(buttonPin) && !craneSequence.playing() ) {
+    craneSequence.play();
+  }
+}
@@ -0,0 +1,64 @@
+#include <MobaTools.h>
+/* Demo for light effects with softleds ( AVR only )
+   8 leds in a line show a K.I.T.T. scanner, a running light or a blinking light.
+   The effects are stored in flash and played in the softled interrupt.
+   loop() only switches to the next effect when the button is pressed.
+*/
+
+// The button must be connected between pin and Gnd
+const byte buttonPin = 2;
+const byte ledPins[] = { 3, 4, 5, 6, 7, 8, 9, 10 };
+const byte ledCount = sizeof(ledPins);
+
+MoToSoftLed led0, led1, led2, led3, led4, led5, led6, led7;
+MoToSoftLed *lights[] = { &led0, &led1, &led2, &led3, &led4, &led5, &led6, &led7 };
+
+// LED_STEP( pattern of the leds ( bit 0 = first led ), time until the next step (ms) )
+const ledStep_t kitt[] PROGMEM = {
+  LED_STEP( 0x01, 100 ), LED_STEP( 0x02, 100 ), LED_STEP( 0x04, 100 ), LED_STEP( 0x08, 100 ),
+  LED_STEP( 0x10, 100 ), LED_STEP( 0x20, 100 ), LED_STEP( 0x40, 100 ), LED_STEP( 0x80, 100 ),
+  LED_STEP( 0x40, 100 ), LED_STEP( 0x20, 100 ), LED_STEP( 0x10, 100 ), LED_STEP( 0x08, 100 ),
+  LED_STEP( 0x04, 100 ), LED_STEP( 0x02, 100 ),
+  LED_EFFECTEND
+};
+
+const ledStep_t runningLight[] PROGMEM = {
+  LED_STEP( 0x11, 150 ), LED_STEP( 0x22, 150 ), LED_STEP( 0x44, 150 ), LED_STEP( 0x88, 150 ),
+  LED_EFFECTEND
+};
+
+const ledStep_t blinker[] PROGMEM = {
+  LED_STEP( 0xff, 500 ), LED_STEP( 0x00, 500 ),
+  LED_EFFECTEND
+};
+
+MoToLedEffect effects[] = {
+  { lights, ledCount, kitt },
+  { lights, ledCount, runningLight },
+  { lights, ledCount, blinker }
+};
+const byte effectCount = sizeof(effects) / sizeof(effects[0]);
+byte effectIx = 0;
+
+bool lastButton = false;
+
+void setup() {
+  pinMode(buttonPin, INPUT_PULLUP);
+  for ( byte i = 0; i < ledCount; i++ ) {
+    lights[i]->attach( ledPins[i] );
+    lights[i]->riseTime( 150 );     // the leds fade out slowly behind the scanner
+  }
+  effects[effectIx].play();
+}
+
+void loop() {
+  bool button = !digitalRead(buttonPin);    // 'button' is 'true' if pin is LOW
+  if ( button && !lastButton ) {
+    // switch to the next effect
+    effects[effectIx].stop();
+    if ( ++effectIx >= effectCount ) effectIx = 0;
+    effects[effectIx].play();
+  }
+  lastButton = button;
+  delay(20);    // debounce
+}
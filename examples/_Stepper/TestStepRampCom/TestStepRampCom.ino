@@ -16,6 +16,8 @@
  *  rds         -> print steppos
  *  szp         -> set zeropoint
  *  wrp         -> aktueller Punkt als Zielpunkt ( mit Rampe! )
+ *  sta         -> Statistik ausgeben ( siehe stepStats.h )
+ *  str         -> Statistik zurücksetzen
  *  
  *  est nn      -> Kommandos in EEPROM ab Befehl nn abarbeiten
  *  esp         -> Abbarbeitung der EEPROM-Komandos stoppen
@@ -74,8 +76,8 @@ const byte A4988Step=6, A4988Dir=5;
 #define printf( x, ... ) { char txtbuf[100]; sprintf_P( txtbuf, PSTR( x ), ##__VA_ARGS__ ) ; Serial.print( txtbuf ); }
 
 // Tokens der Befehle
-enum comTok { dstT, wraT, wrsT, rotT, sspT, sssT, srlT, stpT, movT, rdaT, rdsT, szpT, wrpT, estT, espT, eepT, elsT,nopT,stdT };
-const char comStr[] = "dst,wra,wrs,rot,ssp,sss,srl,stp,mov,rda,rds,szp,wrp,est,esp,eep,els,nop,std";
+enum comTok { dstT, wraT, wrsT, rotT, sspT, sssT, srlT, stpT, movT, rdaT, rdsT, szpT, wrpT, estT, espT, eepT, elsT,nopT,stdT,staT,strT };
+const char comStr[] = "dst,wra,wrs,rot,ssp,sss,srl,stp,mov,rda,rds,szp,wrp,est,esp,eep,els,nop,std,sta,str";
 // Befehlsstruktur im EEPROM
 #define EEMAX   64 // Zahl der einträge im EEPROM
 typedef struct {
@@ -153,6 +155,7 @@ void readCmd( byte eeIx, eeBefehl_t &cmdBuf ) {
     
 }
 
+#include "stepStats.h"
 #include "readCommands.h"
 
 
@@ -177,6 +180,7 @@ void setup() {
 }
 
 void loop() {
+    statUpdate();
     if ( getCmd( interCom ) ) {
         //printEeBefehl( interCom );
         Serial.print("Manu:");
@@ -192,6 +196,7 @@ void loop() {
          if ( comIx == -1 ){
             // Ablauf stoppen
             Serial.println("Auto: Angehalten");
+            statPrint();
             autoZustand = ASTOPPED;
          } else {
              readCmd( comIx++, autoCom );
@@ -224,6 +229,7 @@ void loop() {
              } else {
                 //kein gültiger Eintrag, Ablaufende
                 Serial.println(" Ende");
+                statPrint();
                 autoZustand = ASTOPPED;
              }
         }
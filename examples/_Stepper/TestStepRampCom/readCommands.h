@@ -62,6 +62,7 @@ bool getCmd ( eeBefehl_t &cmdBuf ) {
                         // war kein eep-Befehl -> Ablauf starten
                         comIx = cmdBuf.comPar1;
                         if ( comIx >= 0 && comIx <EEMAX ) autoZustand = NEXTCOM;
+                        statReset();
                         printf( "Starte autom. Ablauf ab Index %d\n\r", comIx );
                         fulCmd = false;
                     }
@@ -126,19 +127,23 @@ void execCmd( eeBefehl_t &cmdBuf ) {
         break;
       case dstT: // ===============================  dst nnn     -> doSteps( +/-nnnL ) ==========
         printf(" Move: %ld\n\r",cmdBuf.comPar1 );
+        statMoveCmd( cmdBuf.comPar1 );
         myStepper.doSteps( cmdBuf.comPar1 );
         break;
       case wraT: // ===============================  wra nnn     -> write( +/-angleL ) ===========
         printf(" MoveTo: %ld\n\r",cmdBuf.comPar1 );
+        statMoveCmd( cmdBuf.comPar1 * stPerRev / 360 - myStepper.readSteps() );
         myStepper.write( cmdBuf.comPar1 );
         break;
       case wrsT: // ===============================  wrs nnn     -> writeSteps ( +/-stepsL ) ======
         printf(" MoveTo: %ld\n\r",cmdBuf.comPar1 );
+        statMoveCmd( cmdBuf.comPar1 - myStepper.readSteps() );
         myStepper.writeSteps( cmdBuf.comPar1 );
         break;
       case wrpT: // ===============================  wrp        -> writeSteps ( readStreps() ) ======
         steps = myStepper.readSteps();
         printf(" MoveTo: %ld\n\r",steps );
+        statMoveCmd( 0 );
         myStepper.writeSteps( steps );
         break;
       case rotT: // ===============================  rot d       -> rotate( +/-direction ); =======
@@ -188,6 +193,14 @@ void execCmd( eeBefehl_t &cmdBuf ) {
      case nopT:
        Serial.println( " NOP" );
        break;
+     case staT: // =============================== sta         -> Statistik ausgeben ==================
+       Serial.println();
+       statPrint();
+       break;
+     case strT: // =============================== str         -> Statistik zurücksetzen ==============
+       Serial.println( " Statistik zurückgesetzt" );
+       statReset();
+       break;
      default:
        Serial.println("Kommando unbekannt");
     }
@@ -0,0 +1,66 @@
+// Statistik der Bewegungen für automatische Tests ( Befehle 'sta' und 'str' )
+// Am Ende eines automatischen Ablaufs wird die Statistik als eine Zeile ausgegeben:
+// STAT vmax=<steps/10sec> ramp=<steps> over=<steps> isrMax=<us> isrOvr=<n> late=<n> lateMax=<us>
+// vmax:    höchste erreichte Geschwindigkeit
+// ramp:    Zahl der Schritte vom Stillstand bis zum Erreichen von vmax ( letzte Beschleunigung )
+// over:    max. Schritte, die nach einem Positionierbefehl noch in die alte Richtung gefahren wurden
+//          ( Überschwingen bei Richtungsumkehr ). Gemessen wird nur, wenn das neue Ziel hinter der
+//          aktuellen Position liegt ( in Bewegungsrichtung gesehen ).
+// isr...:  nur wenn MOTO_STATS in MobaTools.h aktiviert ist ( sonst 0 )
+
+struct {
+    int32_t maxSpeed;       // max. Betrag von getSpeedSteps()
+    long    rampSteps;      // Schritte vom Start bis zur letzten Geschwindigkeitserhöhung
+    long    overshoot;      // max. Weg in alter Richtung nach Positionierbefehl
+    // interne Hilfswerte
+    int32_t lastSpeed;
+    long    startPos;       // Position beim Start aus dem Stillstand
+    long    revPos;         // Position bei Positionierbefehl während der Bewegung
+    int8_t  revDir;         // Richtung bei Positionierbefehl ( 0: keine Messung aktiv )
+} stat;
+
+void statReset() {
+    memset( &stat, 0, sizeof( stat ) );
+    MoToStats::reset();
+    MoToStats::reset( myStepper );
+}
+
+void statMoveCmd( long steps ) {
+    // wird vor jedem Positionierbefehl aufgerufen, steps = Weg von der aktuellen Position zum neuen Ziel
+    int32_t speed = myStepper.getSpeedSteps();
+    if ( speed != 0 && ( steps == 0 || ( steps > 0 ) != ( speed > 0 ) ) ) {
+        // das neue Ziel liegt hinter der aktuellen Position -> Überschwingen messen
+        stat.revPos = myStepper.readSteps();
+        stat.revDir = speed > 0 ? 1 : -1;
+    }
+}
+
+void statUpdate() {
+    // wird in jedem loop-Durchlauf aufgerufen
+    int32_t speed = myStepper.getSpeedSteps();
+    long pos = myStepper.readSteps();
+    if ( stat.lastSpeed == 0 && speed != 0 ) stat.startPos = pos;
+    if ( abs( speed ) > abs( stat.lastSpeed ) ) {
+        if ( abs( speed ) >= stat.maxSpeed ) {
+            stat.maxSpeed = abs( speed );
+            stat.rampSteps = abs( pos - stat.startPos );
+        }
+    }
+    if ( stat.revDir != 0 ) {
+        if ( speed == 0 || ( speed > 0 ) != ( stat.revDir > 0 ) ) {
+            // Richtung hat gewechselt oder Motor steht -> Messung beendet
+            stat.revDir = 0;
+        } else {
+            long over = ( pos - stat.revPos ) * stat.revDir;
+            if ( over > stat.overshoot ) stat.overshoot = over;
+        }
+    }
+    stat.lastSpeed = speed;
+}
+
+void statPrint() {
+    printf( "STAT vmax=%ld ramp=%ld over=%ld ", (long)stat.maxSpeed, stat.rampSteps, stat.overshoot );
+    printf( "isrMax=%lu isrOvr=%u ", (unsigned long)MoToStats::tics2micros( MoToStats::maxIsrTics() ), MoToStats::isrOverruns() );
+    printf( "late=%u lateMax=%lu\n\r", MoToStats::lateSteps( myStepper ),
+                                       (unsigned long)MoToStats::tics2micros( MoToStats::maxLateTics( myStepper ) ) );
+}
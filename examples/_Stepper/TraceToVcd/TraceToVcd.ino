@@ -0,0 +1,119 @@
+/*  Pulse timing als VCD-Datei ausgeben
+ *  Die Ereignisse des ISR-Trace ( MoToTrace ) werden in ein VCD-File umgesetzt, und über die serielle
+ *  Schnittstelle ausgegeben. Die Ausgabe des seriellen Monitors in einer Datei speichern ( ab der Zeile
+ *  '$timescale' ), und z.B. mit GTKWave ansehen. Zwei Aufzeichnungen ( vor und nach einer Änderung )
+ *  können so Flanke für Flanke verglichen werden.
+ *  In MobaTools.h muss dazu MOTO_TRACE aktiviert werden. Dieses Beispiel läuft nicht auf ESP8266!
+ */
+/*  Output pulse timing as VCD file
+ *  The events of the ISR trace ( MoToTrace ) are converted to a VCD file, which is printed to the
+ *  serial interface. Save the output of the serial monitor to a file ( starting with the line
+ *  '$timescale' ) and view it e.g. with GTKWave. This way two recordings ( before and after a change )
+ *  can be compared edge by edge.
+ *  MOTO_TRACE must be activated in MobaTools.h. This example does not run on ESP8266!
+ */
+#include <MobaTools.h>
+#ifndef MOTO_TRACE
+#error "MOTO_TRACE must be defined in MobaTools.h"
+#endif
+
+const byte stepPin = 6, dirPin = 5, servoPin = 9, ledPin = 10;
+const bool traceIrq = false;    // also show the stepper/softled IRQ ( creates a lot of serial output )
+
+MoToStepper myStepper( 800, STEPDIR );
+MoToServo myServo;
+MoToSoftLed myLed;
+
+// VCD signal ids: step pulse of stepper 0 = 's', servo pulse = 'v', IRQ = 'i'
+uint32_t vcdTime;               // actual VCD time ( µs, unwrapped trace time )
+uint16_t lastTraceTime;
+bool stepHigh = false;          // step pulse is reset with next IRQ
+uint32_t servoOff = 0;          // VCD time of end of servo pulse ( 0 = no pulse active )
+
+void vcdEdge( uint32_t time, char id, bool level ) {
+    static uint32_t lastVcdTime = 0xffffffff;
+    if ( time != lastVcdTime ) {
+        Serial.print('#'); Serial.println( time );
+        lastVcdTime = time;
+    }
+    Serial.print( level ? '1' : '0' ); Serial.println( id );
+}
+
+void vcdHeader() {
+    Serial.println(F("$timescale 1us $end"));
+    Serial.println(F("$scope module MobaTools $end"));
+    Serial.println(F("$var wire 1 s step $end"));
+    Serial.println(F("$var wire 1 v servo $end"));
+    if ( traceIrq ) Serial.println(F("$var wire 1 i irq $end"));
+    Serial.println(F("$upscope $end"));
+    Serial.println(F("$enddefinitions $end"));
+}
+
+void vcdEvent( traceEvent_t &event ) {
+    // unwrap 16-bit trace time. Events of a nested IRQ may be some µs 'older'
+    uint16_t delta = event.time - lastTraceTime;
+    if ( delta < 0x8000 ) {
+        vcdTime += delta;
+        lastTraceTime = event.time;
+    }
+    if ( servoOff && servoOff <= vcdTime ) {
+        vcdEdge( servoOff, 'v', 0 );
+        servoOff = 0;
+    }
+    switch ( event.id ) {
+      case TR_STEPIRQ:
+        if ( stepHigh ) vcdEdge( vcdTime, 's', 0 );
+        stepHigh = false;
+        if ( traceIrq ) vcdEdge( vcdTime, 'i', 1 );
+        break;
+      case TR_NEXTIRQ:
+        if ( traceIrq ) vcdEdge( vcdTime, 'i', 0 );
+        break;
+      case TR_STEP:
+        if ( event.ix == 0 ) {
+            vcdEdge( vcdTime, 's', 1 );
+            stepHigh = true;
+        }
+        break;
+      case TR_SERVO:
+        if ( event.ix == 0 ) {
+            vcdEdge( vcdTime, 'v', 1 );
+            servoOff = vcdTime + MoToStats::tics2micros( event.value );
+        }
+        break;
+    }
+}
+
+void setup() {
+    Serial.begin( 115200 );
+    while ( !Serial );
+    myStepper.attach( stepPin, dirPin );
+    myStepper.setSpeedSteps( 2000, 100 );   // 200 steps/sec, ramp 100 steps
+    myServo.attach( servoPin );
+    myLed.attach( ledPin );
+    myLed.riseTime( 500 );
+    vcdHeader();
+    MoToTrace::clear();
+    vcdTime = 0;
+    lastTraceTime = micros();
+}
+
+void loop() {
+    traceEvent_t event;
+    static uint16_t lastLost = 0;
+    while ( MoToTrace::read( event ) ) vcdEvent( event );
+    if ( MoToTrace::lost() != lastLost ) {
+        // the serial output was too slow
+        lastLost = MoToTrace::lost();
+        Serial.print(F("$comment lost events: ")); Serial.print( lastLost ); Serial.println(F(" $end"));
+    }
+    
+    if ( !myStepper.moving() ) {
+        // move back and forth, servo and led follow the direction
+        static bool forward = false;
+        forward = !forward;
+        myStepper.doSteps( forward ? 400 : -400 );
+        myServo.write( forward ? 150 : 30 );
+        myLed.write( forward ? ON : OFF );
+    }
+}
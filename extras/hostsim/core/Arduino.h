@@ -0,0 +1,161 @@
+#ifndef HOSTSIM_ARDUINO_H
+#define HOSTSIM_ARDUINO_H
+// Arduino core of the host simulation: an ATmega328P ( Arduino Uno ) with timer 1 and the ports B, C, D.
+// Only what MobaTools needs is simulated. The timer runs in simulated time, see simcore.h.
+// With SIM_MEGA the pins and ports of an Arduino Mega ( 70 pins, ports A..L ) are simulated, e.g. for
+// more than 16 servos. The processor is still an ATmega328P, MobaTools uses timer 1 as on the Uno.
+// Attention: on the host 'int' has 32 bits and 'long' 64 bits. The library code uses the
+// fixed width types in all time critical places, but 'int' arithmetic may differ from AVR.
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <type_traits>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#ifdef SIM_MEGA
+#define A0 54
+#define NUM_DIGITAL_PINS 70
+#else
+#define A0 14
+#define NUM_DIGITAL_PINS 20
+#endif
+#define A1 ( A0 + 1 )
+#define A2 ( A0 + 2 )
+#define A3 ( A0 + 3 )
+#define A4 ( A0 + 4 )
+#define A5 ( A0 + 5 )
+#define NOT_A_PIN 0
+
+#define __AVR__ 1
+#define __AVR_MEGA__ 1
+#define __AVR_ATmega328P__ 1
+#define clockCyclesPerMicrosecond() 16
+
+#define PROGMEM
+#define PSTR(x) x
+#define F(x) x
+#define snprintf_P snprintf
+#define sprintf_P sprintf
+#define pgm_read_byte(a)  (*(const uint8_t*)(a))
+#define pgm_read_word(a)  (*(const uint16_t*)(a))
+#define pgm_read_dword(a) (*(const uint32_t*)(a))
+#define pgm_read_ptr(a)   (*(void * const *)(a))
+
+#define _BV(b) (1<<(b))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+
+// ---------------- registers --------------------------------------
+extern volatile uint8_t SREG;
+extern volatile uint8_t DDRB, DDRC, DDRD, PORTB, PORTC, PORTD, PINB, PINC, PIND;
+#ifdef SIM_MEGA
+extern volatile uint8_t DDRA, DDRE, DDRF, DDRG, DDRH, DDRJ, DDRK, DDRL;
+extern volatile uint8_t PORTA, PORTE, PORTF, PORTG, PORTH, PORTJ, PORTK, PORTL;
+extern volatile uint8_t PINA, PINE, PINF, PING, PINH, PINJ, PINK, PINL;
+#endif
+extern volatile uint8_t TIMSK1, TIFR1, TCCR1A, TCCR1B;
+extern volatile uint16_t OCR1A, OCR1B, ICR1;
+extern volatile uint8_t SPCR, SPSR, SPDR;
+uint16_t simTcnt();                 // timer 1 counter at the current simulated time
+#define TCNT1  simTcnt()
+#define TCNT1H TCNT1
+#define SPCR SPCR
+
+#define OCIE1A 1
+#define OCIE1B 2
+#define WGM13 4
+#define WGM12 3
+#define CS11 1
+#define SPIE 7
+#define SPE 6
+#define DORD 5
+#define MSTR 4
+#define CPOL 3
+#define CPHA 2
+#define SPR1 1
+#define SPR0 0
+#define MOSI 11
+#define SCK 13
+#define SS 10
+
+// interrupts are never preempted in the simulation ( an ISR runs at a frozen point of time ),
+// so cli() and sei() only maintain the I-bit.
+#define cli() ( SREG &= 0x7f )
+#define sei() ( SREG |= 0x80 )
+#define ISR(vector) extern "C" void vector(void); extern "C" void vector(void)
+extern "C" void TIMER1_COMPA_vect(void) __attribute__((weak));
+extern "C" void TIMER1_COMPB_vect(void) __attribute__((weak));
+
+// ---------------- Arduino API --------------------------------------
+void pinMode( uint8_t pin, uint8_t mode );
+void digitalWrite( uint8_t pin, uint8_t val );
+int  digitalRead( uint8_t pin );
+unsigned long micros();
+unsigned long millis();
+void delay( unsigned long ms );           // simulated time is running
+void delayMicroseconds( unsigned int us );
+static inline void noInterrupts() { cli(); }
+static inline void interrupts() { sei(); }
+volatile uint8_t *portOutputRegister( uint8_t port );
+volatile uint8_t *portInputRegister( uint8_t port );
+uint8_t digitalPinToPort( uint8_t pin );
+uint8_t digitalPinToBitMask( uint8_t pin );
+long map( long x, long in_min, long in_max, long out_min, long out_max );
+long random( long howbig );
+long random( long howsmall, long howbig );
+
+// like the macros of the Arduino core: the result has the common type of both arguments
+template<class A, class B> auto min( A a, B b ) -> typename std::common_type<A,B>::type { return a<b?a:b; }
+template<class A, class B> auto max( A a, B b ) -> typename std::common_type<A,B>::type { return a>b?a:b; }
+template<class A, class B, class C> A constrain( A a, B b, C c ) { return a<b ? b : ( a>c ? c : a ); }
+
+// ---------------- Print / Serial -----------------------------------
+#define DEC 10
+#define HEX 16
+#define BIN 2
+class Print {
+  public:
+    virtual size_t write( uint8_t c ) = 0;
+    size_t write( const char *s ) { size_t n=0; while ( *s ) n += write( (uint8_t)*s++ ); return n; }
+    size_t print( const char *s ) { return write( s ); }
+    size_t print( char c ) { return write( (uint8_t)c ); }
+    size_t print( unsigned long n, int base = DEC );
+    size_t print( long n, int base = DEC );
+    size_t print( unsigned int n, int base = DEC ) { return print( (unsigned long)n, base ); }
+    size_t print( int n, int base = DEC ) { return print( (long)n, base ); }
+    size_t print( unsigned char n, int base = DEC ) { return print( (unsigned long)n, base ); }
+    size_t print( unsigned long long n, int base = DEC ) { return print( (unsigned long)n, base ); }
+    size_t print( long long n, int base = DEC ) { return print( (long)n, base ); }
+    size_t print( double d, int digits = 2 );
+    template<class T> size_t println( T v ) { size_t n = print( v ); return n + println(); }
+    template<class T> size_t println( T v, int p ) { size_t n = print( v, p ); return n + println(); }
+    size_t println() { return write( (uint8_t)'\n' ); }
+};
+
+// input is given by sim::serialInput, output goes to stdout or to the hook of sim::onSerialOutput
+class HardwareSerial : public Print {
+  public:
+    void begin( long ) {}
+    operator bool() { return true; }
+    int available();
+    int read();
+    size_t readBytes( char *buffer, size_t length );
+    void flush() { fflush( stdout ); }
+    using Print::write;
+    size_t write( uint8_t c ) override;
+};
+extern HardwareSerial Serial;
+
+#endif
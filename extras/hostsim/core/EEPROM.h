@@ -0,0 +1,20 @@
+#ifndef HOSTSIM_EEPROM_H
+#define HOSTSIM_EEPROM_H
+// EEPROM of the host simulation ( in RAM, erased state is 0xff ).
+// It is larger than on the ATmega328P, because 'long' has 64 bits on the host.
+#include <Arduino.h>
+
+class EEPROMClass {
+  public:
+    EEPROMClass() { memset( _data, 0xff, sizeof(_data) ); }
+    uint8_t read( int idx ) { return _data[idx]; }
+    void write( int idx, uint8_t val ) { _data[idx] = val; }
+    void update( int idx, uint8_t val ) { _data[idx] = val; }
+    uint16_t length() { return sizeof(_data); }
+    template<class T> T &get( int idx, T &t ) { memcpy( (void*)&t, &_data[idx], sizeof(T) ); return t; }
+    template<class T> const T &put( int idx, const T &t ) { memcpy( &_data[idx], (const void*)&t, sizeof(T) ); return t; }
+  private:
+    uint8_t _data[4096];
+};
+extern EEPROMClass EEPROM;
+#endif
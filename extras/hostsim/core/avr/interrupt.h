@@ -0,0 +1,2 @@
+// avr/interrupt.h of the host simulation: everything is declared in Arduino.h
+#include <Arduino.h>
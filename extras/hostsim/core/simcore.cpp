@@ -0,0 +1,381 @@
+// Simulated ATmega328P for the host simulation: timer 1, ports and the Arduino API
+// ( with SIM_MEGA the pins and ports of the Arduino Mega )
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <time.h>
+#include "simcore.h"
+
+volatile uint8_t SREG = 0x80;
+volatile uint8_t DDRB, DDRC, DDRD, PORTB, PORTC, PORTD, PINB, PINC, PIND;
+#ifdef SIM_MEGA
+volatile uint8_t DDRA, DDRE, DDRF, DDRG, DDRH, DDRJ, DDRK, DDRL;
+volatile uint8_t PORTA, PORTE, PORTF, PORTG, PORTH, PORTJ, PORTK, PORTL;
+volatile uint8_t PINA, PINE, PINF, PING, PINH, PINJ, PINK, PINL;
+#endif
+volatile uint8_t TIMSK1, TIFR1, TCCR1A, TCCR1B;
+volatile uint16_t OCR1A, OCR1B, ICR1;
+volatile uint8_t SPCR, SPSR, SPDR;
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+
+// port numbers as in the Arduino AVR core ( index of the port registers )
+const uint8_t PA = 1, PB = 2, PC = 3, PD = 4, PE = 5, PF = 6, PG = 7, PH = 8, PJ = 10, PK = 11, PL = 12;
+struct portRegs_t { volatile uint8_t *out, *in, *mode; };
+#ifdef SIM_MEGA
+static const portRegs_t portRegs[] = { { nullptr, nullptr, nullptr },
+    { &PORTA, &PINA, &DDRA }, { &PORTB, &PINB, &DDRB }, { &PORTC, &PINC, &DDRC }, { &PORTD, &PIND, &DDRD },
+    { &PORTE, &PINE, &DDRE }, { &PORTF, &PINF, &DDRF }, { &PORTG, &PING, &DDRG }, { &PORTH, &PINH, &DDRH },
+    { nullptr, nullptr, nullptr },
+    { &PORTJ, &PINJ, &DDRJ }, { &PORTK, &PINK, &DDRK }, { &PORTL, &PINL, &DDRL } };
+// pin -> port and bit, as in pins_arduino.h of the Arduino Mega
+static const uint8_t pinPort[NUM_DIGITAL_PINS] = {
+    PE, PE, PE, PE, PG, PE, PH, PH, PH, PH, PB, PB, PB, PB, PJ, PJ, PH, PH, PD, PD,     //  0..19
+    PD, PD, PA, PA, PA, PA, PA, PA, PA, PA, PC, PC, PC, PC, PC, PC, PC, PC, PD, PG,     // 20..39
+    PG, PG, PL, PL, PL, PL, PL, PL, PL, PL, PB, PB, PB, PB, PF, PF, PF, PF, PF, PF,     // 40..59
+    PF, PF, PK, PK, PK, PK, PK, PK, PK, PK };                                           // 60..69
+static const uint8_t pinBit[NUM_DIGITAL_PINS] = {
+    0, 1, 4, 5, 5, 3, 3, 4, 5, 6, 4, 5, 6, 7, 1, 0, 1, 0, 3, 2,
+    1, 0, 0, 1, 2, 3, 4, 5, 6, 7, 7, 6, 5, 4, 3, 2, 1, 0, 7, 2,
+    1, 0, 7, 6, 5, 4, 3, 2, 1, 0, 3, 2, 1, 0, 0, 1, 2, 3, 4, 5,
+    6, 7, 0, 1, 2, 3, 4, 5, 6, 7 };
+#else
+static const portRegs_t portRegs[] = { { nullptr, nullptr, nullptr }, { nullptr, nullptr, nullptr },
+    { &PORTB, &PINB, &DDRB }, { &PORTC, &PINC, &DDRC }, { &PORTD, &PIND, &DDRD } };
+static const uint8_t pinPort[NUM_DIGITAL_PINS] = {
+    PD, PD, PD, PD, PD, PD, PD, PD, PB, PB, PB, PB, PB, PB, PC, PC, PC, PC, PC, PC };
+static const uint8_t pinBit[NUM_DIGITAL_PINS] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5 };
+#endif
+const uint8_t PORTS = sizeof( portRegs ) / sizeof( portRegs[0] );
+
+namespace sim {
+
+static tick_t curTime = 0;
+static tick_t cpuFree = 0;          // time when the running ISR is finished
+static uint32_t rndState = 1;
+static isrHook_t isrHook = nullptr;
+static edgeHook_t edgeHook = nullptr;
+
+struct channel_t {
+    volatile uint16_t *ocr;
+    uint8_t enableMask;
+    void (*isr)(void);
+    uint16_t ocrShadow;             // to detect writes to the compare register
+    tick_t armFrom;                 // search for the next match from this time on
+    bool flag;                      // compare match flag ( TIFR1 )
+    tick_t ready;                   // time when the ISR can start ( match + injected latency )
+    uint32_t count;
+    uint64_t hostNs;                // runtime of the ISR on the host
+    latency_t lat;
+};
+static channel_t chan[VECTORS] = {
+    { &OCR1A, _BV(OCIE1A), TIMER1_COMPA_vect, 0, 0, false, 0, 0, 0, { 4, 0, 0, 0 } },
+    { &OCR1B, _BV(OCIE1B), TIMER1_COMPB_vect, 0, 0, false, 0, 0, 0, { 4, 0, 0, 0 } },
+};
+
+// ------------------ port pins ---------------------------------------
+static uint8_t portShadow[PORTS];
+static uint8_t inputLevel[NUM_DIGITAL_PINS];
+static uint8_t pinModes[NUM_DIGITAL_PINS];
+
+static void scanPins() {
+    bool changed = false;
+    for ( uint8_t p = 0; p < PORTS; p++ ) {
+        if ( portRegs[p].out && *portRegs[p].out != portShadow[p] ) changed = true;
+    }
+    if ( !changed ) return;
+    // report the changes in the order of the pin numbers
+    for ( uint8_t pin = 0; pin < NUM_DIGITAL_PINS; pin++ ) {
+        uint8_t port = pinPort[pin], mask = _BV( pinBit[pin] );
+        uint8_t level = *portRegs[port].out & mask;
+        if ( level != ( portShadow[port] & mask ) && edgeHook ) edgeHook( pin, level != 0, curTime );
+    }
+    for ( uint8_t p = 0; p < PORTS; p++ ) {
+        if ( portRegs[p].out ) portShadow[p] = *portRegs[p].out;
+    }
+}
+
+// ------------------ timer 1 -------------------------------------------
+static bool timerRunning() {
+    return ( TCCR1B & 7 ) != 0;
+}
+
+static uint32_t timerPeriod() {
+    // CTC mode with ICR1 as TOP, otherwise normal mode
+    if ( ( TCCR1B & ( _BV(WGM13) | _BV(WGM12) ) ) && ICR1 > 0 ) return (uint32_t)ICR1 + 1;
+    return 0x10000;
+}
+
+static tick_t nextMatch( const channel_t &c ) {
+    if ( !timerRunning() ) return NEVER;
+    uint32_t per = timerPeriod();
+    if ( *c.ocr >= per ) return NEVER;      // compare value is never reached
+    tick_t m = c.armFrom - c.armFrom % per + *c.ocr;
+    if ( m < c.armFrom ) m += per;
+    return m;
+}
+
+static void checkCompareRegs() {
+    // writing a compare register blocks a match at the current count, the next
+    // match is searched from the next tic on.
+    static bool wasRunning = false;
+    bool running = timerRunning();
+    for ( channel_t &c : chan ) {
+        if ( *c.ocr != c.ocrShadow || ( running && !wasRunning ) ) {
+            c.ocrShadow = *c.ocr;
+            c.armFrom = curTime + 1;
+        }
+    }
+    wasRunning = running;
+}
+
+tick_t now() {
+    return curTime;
+}
+
+void run( tick_t tics ) {
+    runUntil( curTime + tics );
+}
+
+void runUntil( tick_t until ) {
+    // changes in the main context are reported at the current time
+    scanPins();
+    checkCompareRegs();
+    while ( true ) {
+        // next event: a compare match or the start of a pending ISR
+        tick_t tNext = NEVER;
+        int8_t match = -1, service = -1;
+        for ( uint8_t v = 0; v < VECTORS; v++ ) {
+            tick_t t = nextMatch( chan[v] );
+            if ( t < tNext ) { tNext = t; match = v; }
+        }
+        for ( uint8_t v = 0; v < VECTORS; v++ ) {
+            // if both are ready at the same time, COMPA has the higher priority
+            channel_t &c = chan[v];
+            if ( !c.flag || !( TIMSK1 & c.enableMask ) || c.isr == nullptr ) continue;
+            tick_t t = c.ready > cpuFree ? c.ready : cpuFree;
+            if ( t < tNext ) { tNext = t; service = v; match = -1; }
+        }
+        if ( tNext == NEVER || tNext > until ) break;
+        if ( match >= 0 ) {
+            channel_t &c = chan[match];
+            if ( !c.flag ) {
+                c.flag = true;
+                c.ready = tNext + c.lat.fixed + ( c.lat.randMax ? rand32() % ( c.lat.randMax + 1u ) : 0 );
+            }
+            c.armFrom = tNext + 1;
+            if ( tNext > curTime ) curTime = tNext;
+        } else {
+            channel_t &c = chan[service];
+            c.flag = false;
+            if ( tNext + c.lat.entry > curTime ) curTime = tNext + c.lat.entry;
+            timespec t0, t1;
+            clock_gettime( CLOCK_MONOTONIC, &t0 );
+            c.isr();
+            clock_gettime( CLOCK_MONOTONIC, &t1 );
+            c.hostNs += ( t1.tv_sec - t0.tv_sec ) * 1000000000ull + t1.tv_nsec - t0.tv_nsec;
+            c.count++;
+            scanPins();
+            checkCompareRegs();
+            if ( isrHook ) isrHook( (vector_t)service, curTime );
+            cpuFree = curTime + c.lat.cost;
+        }
+    }
+    if ( until > curTime ) curTime = until;
+}
+
+void setLatency( vector_t vec, const latency_t &lat ) {
+    chan[vec].lat = lat;
+}
+
+latency_t getLatency( vector_t vec ) {
+    return chan[vec].lat;
+}
+
+void seed( uint32_t s ) {
+    rndState = s ? s : 1;
+}
+
+uint32_t rand32() {
+    // xorshift32, the simulation must be reproducible on every host
+    rndState ^= rndState << 13;
+    rndState ^= rndState >> 17;
+    rndState ^= rndState << 5;
+    return rndState;
+}
+
+void onIsr( isrHook_t hook ) {
+    isrHook = hook;
+}
+
+uint32_t isrCount( vector_t vec ) {
+    return chan[vec].count;
+}
+
+uint64_t isrHostNs( vector_t vec ) {
+    return chan[vec].hostNs;
+}
+
+void onEdge( edgeHook_t hook ) {
+    edgeHook = hook;
+}
+
+uint8_t pinLevel( uint8_t pin ) {
+    uint8_t port = digitalPinToPort( pin );
+    if ( port == NOT_A_PIN ) return 0;
+    return ( *portOutputRegister( port ) & digitalPinToBitMask( pin ) ) != 0;
+}
+
+void setInput( uint8_t pin, uint8_t level ) {
+    if ( pin < NUM_DIGITAL_PINS ) inputLevel[pin] = level;
+}
+
+// ------------------ serial interface ------------------------------------
+static char serialBuf[256];
+static uint16_t serialRd, serialWr;     // ring buffer
+static serialHook_t serialHook = nullptr;
+
+void serialInput( const char *text ) {
+    while ( *text ) {
+        uint16_t next = ( serialWr + 1 ) % sizeof(serialBuf);
+        if ( next == serialRd ) break;  // buffer is full
+        serialBuf[serialWr] = *text++;
+        serialWr = next;
+    }
+}
+
+void onSerialOutput( serialHook_t hook ) {
+    serialHook = hook;
+}
+
+} // namespace sim
+
+int HardwareSerial::available() {
+    return ( sim::serialWr + sizeof(sim::serialBuf) - sim::serialRd ) % sizeof(sim::serialBuf);
+}
+
+int HardwareSerial::read() {
+    if ( sim::serialRd == sim::serialWr ) return -1;
+    char c = sim::serialBuf[sim::serialRd];
+    sim::serialRd = ( sim::serialRd + 1 ) % sizeof(sim::serialBuf);
+    return (uint8_t)c;
+}
+
+size_t HardwareSerial::readBytes( char *buffer, size_t length ) {
+    size_t n = 0;
+    int c;
+    while ( n < length && ( c = read() ) >= 0 ) buffer[n++] = c;
+    return n;
+}
+
+size_t HardwareSerial::write( uint8_t c ) {
+    if ( sim::serialHook ) {
+        sim::serialHook( c );
+        return 1;
+    }
+    return fputc( c, stdout ) == EOF ? 0 : 1;
+}
+
+// ------------------ Arduino API ------------------------------------------
+uint16_t simTcnt() {
+    return sim::curTime % sim::timerPeriod();
+}
+
+uint8_t digitalPinToPort( uint8_t pin ) {
+    return pin < NUM_DIGITAL_PINS ? pinPort[pin] : NOT_A_PIN;
+}
+
+uint8_t digitalPinToBitMask( uint8_t pin ) {
+    return pin < NUM_DIGITAL_PINS ? _BV( pinBit[pin] ) : 0;
+}
+
+volatile uint8_t *portOutputRegister( uint8_t port ) {
+    return port < PORTS ? portRegs[port].out : nullptr;
+}
+
+volatile uint8_t *portInputRegister( uint8_t port ) {
+    return port < PORTS ? portRegs[port].in : nullptr;
+}
+
+static volatile uint8_t *portModeRegister( uint8_t port ) {
+    return port < PORTS ? portRegs[port].mode : nullptr;
+}
+
+void pinMode( uint8_t pin, uint8_t mode ) {
+    uint8_t port = digitalPinToPort( pin );
+    if ( port == NOT_A_PIN ) return;
+    sim::pinModes[pin] = mode;
+    if ( mode == OUTPUT ) *portModeRegister( port ) |= digitalPinToBitMask( pin );
+    else *portModeRegister( port ) &= ~digitalPinToBitMask( pin );
+    if ( mode == INPUT_PULLUP ) sim::inputLevel[pin] = HIGH;
+}
+
+void digitalWrite( uint8_t pin, uint8_t val ) {
+    uint8_t port = digitalPinToPort( pin );
+    if ( port == NOT_A_PIN ) return;
+    if ( val ) *portOutputRegister( port ) |= digitalPinToBitMask( pin );
+    else *portOutputRegister( port ) &= ~digitalPinToBitMask( pin );
+}
+
+int digitalRead( uint8_t pin ) {
+    if ( pin >= NUM_DIGITAL_PINS ) return LOW;
+    if ( sim::pinModes[pin] == OUTPUT ) return sim::pinLevel( pin );
+    return sim::inputLevel[pin];
+}
+
+unsigned long micros() {
+    return sim::curTime / sim::TICS_PER_US;
+}
+
+unsigned long millis() {
+    return sim::curTime / ( 1000 * sim::TICS_PER_US );
+}
+
+void delay( unsigned long ms ) {
+    sim::runMs( ms );
+}
+
+void delayMicroseconds( unsigned int us ) {
+    sim::runUs( us );
+}
+
+long map( long x, long in_min, long in_max, long out_min, long out_max ) {
+    return ( x - in_min ) * ( out_max - out_min ) / ( in_max - in_min ) + out_min;
+}
+
+long random( long howbig ) {
+    if ( howbig <= 0 ) return 0;
+    return sim::rand32() % howbig;
+}
+
+long random( long howsmall, long howbig ) {
+    if ( howsmall >= howbig ) return howsmall;
+    return random( howbig - howsmall ) + howsmall;
+}
+
+// ------------------ Print ------------------------------------------------
+size_t Print::print( unsigned long n, int base ) {
+    char buf[8 * sizeof(long) + 1];
+    char *p = &buf[sizeof(buf) - 1];
+    *p = '\0';
+    if ( base < 2 ) base = 10;
+    do {
+        uint8_t d = n % base;
+        *--p = d < 10 ? '0' + d : 'A' + d - 10;
+        n /= base;
+    } while ( n );
+    return write( p );
+}
+
+size_t Print::print( long n, int base ) {
+    if ( base == 10 && n < 0 ) {
+        return print( '-' ) + print( (unsigned long)-n, 10 );
+    }
+    return print( (unsigned long)n, base );
+}
+
+size_t Print::print( double d, int digits ) {
+    char buf[40];
+    snprintf( buf, sizeof(buf), "%.*f", digits, d );
+    return write( buf );
+}
@@ -0,0 +1,57 @@
+#ifndef HOSTSIM_SIMCORE_H
+#define HOSTSIM_SIMCORE_H
+// Simulated time and timer 1 of the host simulation.
+// The simulated time is counted in timer tics ( 0.5µs ). Timer 1 runs in CTC mode with ICR1 as TOP,
+// the compare matches with OCR1A and OCR1B call TIMER1_COMPA_vect and TIMER1_COMPB_vect.
+// An ISR runs at a frozen point of time: TCNT1 and micros() don't change while it is executed.
+// Where the ISR starts and how long it blocks the CPU is set by the latency model:
+//   entry    tics from the start of the ISR to the first statement of the ISR body ( prologue )
+//   fixed    tics the ISR is delayed after the compare match ( e.g. a cli section in loop() )
+//   randMax  an additional random delay of 0..randMax tics, drawn at every compare match
+//   cost     tics the ISR body occupies the CPU. Other ISRs cannot start during this time.
+// Pin changes are detected after every ISR call and on every entry into sim::run(). They are
+// reported to the edge callback together with the simulated time.
+#include <stdint.h>
+
+namespace sim {
+    typedef uint64_t tick_t;
+    const tick_t NEVER = UINT64_MAX;
+    const uint8_t TICS_PER_US = 2;
+    enum vector_t : uint8_t { COMPA, COMPB, VECTORS };
+
+    struct latency_t {
+        uint16_t entry;
+        uint16_t fixed;
+        uint16_t randMax;
+        uint16_t cost;
+    };
+
+    tick_t now();                               // current simulated time
+    void run( tick_t tics );                    // advance simulated time by 'tics'
+    void runUntil( tick_t time );
+    static inline void runMs( uint32_t ms ) { run( (tick_t)ms * 1000 * TICS_PER_US ); }
+    static inline void runUs( uint32_t us ) { run( (tick_t)us * TICS_PER_US ); }
+
+    void setLatency( vector_t vec, const latency_t &lat );
+    latency_t getLatency( vector_t vec );
+    void seed( uint32_t s );                    // seed of the random latency ( default 1 )
+    uint32_t rand32();
+
+    // called after every ISR, 'entry' is the time of the ISR body
+    typedef void (*isrHook_t)( vector_t vec, tick_t entry );
+    void onIsr( isrHook_t hook );
+    uint32_t isrCount( vector_t vec );
+    uint64_t isrHostNs( vector_t vec );         // sum of the runtimes of the ISR on the host ( ns )
+
+    // called for every pin change
+    typedef void (*edgeHook_t)( uint8_t pin, uint8_t level, tick_t time );
+    void onEdge( edgeHook_t hook );
+    uint8_t pinLevel( uint8_t pin );            // level of an output pin
+    void setInput( uint8_t pin, uint8_t level ); // level of an input pin ( read by digitalRead )
+
+    // serial interface
+    void serialInput( const char *text );       // text that can be read with Serial.read...
+    typedef void (*serialHook_t)( char c );
+    void onSerialOutput( serialHook_t hook );   // output of Serial.print... ( default: stdout )
+}
+#endif
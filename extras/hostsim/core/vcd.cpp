@@ -0,0 +1,60 @@
+// VCD recorder of the host simulation
+#include <Arduino.h>
+#include "simcore.h"
+#include "vcd.h"
+
+namespace sim {
+
+static FILE *vcdFile = nullptr;
+static char pinIds[NUM_DIGITAL_PINS];   // VCD identifier of the pin, 0 if it is not recorded
+static const char *vcdNames[NUM_DIGITAL_PINS];
+static tick_t lastTime = NEVER;
+
+static void vcdHeader() {
+    fprintf( vcdFile, "$date host simulation $end\n$version MobaTools hostsim $end\n" );
+    fprintf( vcdFile, "$timescale 1ns $end\n$scope module uno $end\n" );
+    for ( uint8_t pin = 0; pin < NUM_DIGITAL_PINS; pin++ ) {
+        if ( pinIds[pin] == 0 ) continue;
+        fprintf( vcdFile, "$var wire 1 %c %s $end\n", pinIds[pin], vcdNames[pin] );
+    }
+    fprintf( vcdFile, "$upscope $end\n$enddefinitions $end\n#%llu\n$dumpvars\n",
+             (unsigned long long)now() * ( 1000 / TICS_PER_US ) );
+    for ( uint8_t pin = 0; pin < NUM_DIGITAL_PINS; pin++ ) {
+        if ( pinIds[pin] ) fprintf( vcdFile, "%u%c\n", pinLevel( pin ), pinIds[pin] );
+    }
+    fprintf( vcdFile, "$end\n" );
+    lastTime = now();
+}
+
+static void vcdEdge( uint8_t pin, uint8_t level, tick_t time ) {
+    if ( vcdFile == nullptr || pin >= NUM_DIGITAL_PINS || pinIds[pin] == 0 ) return;
+    if ( time != lastTime ) {
+        fprintf( vcdFile, "#%llu\n", (unsigned long long)time * ( 1000 / TICS_PER_US ) );
+        lastTime = time;
+    }
+    fprintf( vcdFile, "%u%c\n", level, pinIds[pin] );
+}
+
+bool vcdOpen( const char *fileName ) {
+    vcdFile = fopen( fileName, "w" );
+    if ( vcdFile == nullptr ) return false;
+    vcdHeader();
+    onEdge( vcdEdge );
+    return true;
+}
+
+void vcdPin( uint8_t pin, const char *name ) {
+    static char nextId = '!';
+    if ( pin >= NUM_DIGITAL_PINS ) return;
+    pinIds[pin] = nextId++;
+    vcdNames[pin] = name;
+}
+
+void vcdClose() {
+    if ( vcdFile == nullptr ) return;
+    fprintf( vcdFile, "#%llu\n", (unsigned long long)now() * ( 1000 / TICS_PER_US ) );
+    fclose( vcdFile );
+    vcdFile = nullptr;
+}
+
+} // namespace sim
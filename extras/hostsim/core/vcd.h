@@ -0,0 +1,13 @@
+#ifndef HOSTSIM_VCD_H
+#define HOSTSIM_VCD_H
+// Records the pin changes of the simulation as value change dump ( VCD, IEEE 1364 ).
+// The file can be shown with any waveform viewer ( e.g. GTKWave, PulseView ) and compared
+// with tools/vcddiff. The timescale is 1ns, so times of the recording are exact ( 1 tic = 500ns ).
+#include <stdint.h>
+
+namespace sim {
+    void vcdPin( uint8_t pin, const char *name );       // record this pin ( call before vcdOpen )
+    bool vcdOpen( const char *fileName );               // start recording, false if the file cannot be created
+    void vcdClose();
+}
+#endif
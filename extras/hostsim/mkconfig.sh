@@ -0,0 +1,23 @@
+#!/bin/sh
+# Create a configured copy of MobaTools.h for the host simulation
+# usage: mkconfig.sh <MobaTools.h> <output> [NAME | NAME=VALUE] ...
+# NAME switches on '//#define NAME', NAME=VALUE sets the value of '#define NAME'
+in=$1
+out=$2
+shift 2
+mkdir -p "$(dirname "$out")"
+cp "$in" "$out.tmp"
+for def in "$@"; do
+    name=${def%%=*}
+    if [ "$name" = "$def" ]; then
+        sed -i -E "s|^//[[:space:]]*#define[[:space:]]+$name\b|#define $name|" "$out.tmp"
+    else
+        sed -i -E "s|^([[:space:]]*)(//)?[[:space:]]*#define[[:space:]]+$name\b[[:space:]]+[^[:space:]]+|\1#define $name ${def#*=}|" "$out.tmp"
+    fi
+    if ! grep -q -E "^[[:space:]]*#define[[:space:]]+$name\b" "$out.tmp"; then
+        echo "mkconfig: $name not found in $in" >&2
+        rm -f "$out.tmp"
+        exit 1
+    fi
+done
+mv "$out.tmp" "$out"
@@ -0,0 +1,106 @@
+// Check the angle <-> step conversions of MoToStepper ( write( angle, fact ) and read( factor ) ) against
+// the former computation with 32-bit divisions. Both must give exactly the same results within the
+// range, where the former computation did not overflow ( 'long' has 32 bits on the Arduino ).
+// The library uses a division by multiplication with the reciprocal ( setRecip/recipDiv ) instead.
+// usage: angle_check [-v]
+//   -v  print every checked divisor
+// exit code: 0 = all results are identical, 1 = deviations found
+#include <MobaTools.h>
+#include <algorithm>
+#include "simcore.h"
+
+MoToStepper stepper( 800, STEPDIR );
+
+static bool verbose = false;
+static uint32_t checks = 0, errors = 0;
+
+// the former computations, with the 32-bit arithmetic of the Arduino
+static int32_t oldAngle2Steps( int32_t angleArg, uint8_t fact, int32_t stepsRev ) {
+    int32_t absAngle = angleArg < 0 ? -angleArg : angleArg;
+    int32_t remain = angleArg % ( 360 * fact );
+    if ( remain < 0 ) remain = -remain;
+    int32_t steps = absAngle / ( 360 * fact ) * stepsRev;
+    steps += ( remain * stepsRev + 180 * fact ) / ( 360 * fact );
+    return angleArg < 0 ? -steps : steps;
+}
+
+static int32_t oldSteps2Angle( int32_t steps, uint8_t factor, int32_t stepsRev ) {
+    int32_t tmp = steps < 0 ? -steps : steps;
+    tmp = ( tmp / stepsRev ) * 360 * factor + ( ( ( tmp % stepsRev ) * ( 3600 * factor ) / stepsRev ) + 5 ) / 10;
+    return steps < 0 ? -tmp : tmp;
+}
+
+static void report( const char *what, int32_t stepsRev, uint8_t fact, int32_t arg, long result, long expected ) {
+    if ( errors++ < 10 ) {
+        printf( "%s( %ld, %u ) with %ld steps/rev: %ld, expected %ld\n", what, (long)arg, fact,
+                (long)stepsRev, result, expected );
+    }
+}
+
+static void checkWrite( int32_t stepsRev, uint8_t fact, int32_t angle ) {
+    // the stepper stands at position 0 and has no ramp: stepsToDo() is the number of steps of the move
+    stepper.write( angle, fact );
+    long steps = stepper.stepsToDo();
+    long expected = labs( oldAngle2Steps( angle, fact, stepsRev ) );
+    checks++;
+    if ( steps != expected ) report( "write", stepsRev, fact, angle, steps, expected );
+}
+
+static void checkRead( int32_t stepsRev, uint8_t factor, int32_t pos ) {
+    stepper.setZero( -pos );
+    long angle = stepper.read( factor );
+    long expected = oldSteps2Angle( pos, factor, stepsRev );
+    checks++;
+    if ( angle != expected ) report( "read", stepsRev, factor, pos, angle, expected );
+    stepper.setZero( 0 );
+}
+
+// dividends near multiples of the divisor, at the upper limit and random values
+static void checkDivisor( int32_t stepsRev ) {
+    stepper.setZero( 0, stepsRev );
+    const uint8_t facts[] = { 1, 2, 3, 10, 60, 100, 255 };
+    for ( uint8_t fact : facts ) {
+        // the former computation must not overflow: remain*stepsRev and the number of steps
+        if ( (int64_t)360 * fact * stepsRev >= INT32_MAX ) continue;
+        int64_t maxRevs = ( INT32_MAX - stepsRev ) / stepsRev;
+        int32_t maxAngle = (int32_t)std::min<int64_t>( INT32_MAX, maxRevs * 360 * fact );
+        int32_t period = 360 * fact;
+        for ( int32_t k = 0; k < 4; k++ ) {
+            for ( int32_t d = -2; d <= 2; d++ ) {
+                int32_t base = k == 3 ? maxAngle / period * period : k * period;
+                checkWrite( stepsRev, fact, base + d );
+                checkWrite( stepsRev, fact, -( base + d ) );
+            }
+        }
+        for ( uint32_t i = 0; i < 2000; i++ ) {
+            int32_t angle = sim::rand32() % ( i & 1 ? period : (uint32_t)maxAngle );
+            checkWrite( stepsRev, fact, i & 2 ? -angle : angle );
+        }
+        if ( (int64_t)3600 * fact * stepsRev >= INT32_MAX ) continue;
+        for ( int32_t k = 0; k < 4; k++ ) {
+            for ( int32_t d = -2; d <= 2; d++ ) {
+                int32_t base = k == 3 ? ( INT32_MAX / 360 / fact - 2 ) / stepsRev * stepsRev : k * stepsRev;
+                checkRead( stepsRev, fact, base + d );
+                checkRead( stepsRev, fact, -( base + d ) );
+            }
+        }
+        for ( uint32_t i = 0; i < 2000; i++ ) {
+            // the full revolutions must fit in 32 bits as angle
+            int32_t pos = sim::rand32() % ( i & 1 ? (uint32_t)stepsRev : (uint32_t)( INT32_MAX / 360 / fact ) );
+            checkRead( stepsRev, fact, i & 2 ? -pos : pos );
+        }
+    }
+    if ( verbose ) printf( "%ld steps/rev: %lu checks\n", (long)stepsRev, (unsigned long)checks );
+}
+
+int main( int argc, char *argv[] ) {
+    if ( argc > 1 && strcmp( argv[1], "-v" ) == 0 ) verbose = true;
+    stepper.attach( 2, 3 );
+    stepper.setSpeedSteps( 10000, 0 );      // no ramp: write() sets the number of steps directly
+    const int32_t divisors[] = { 1, 2, 3, 7, 48, 64, 96, 200, 400, 513, 800, 1600, 2037, 2048, 3200,
+                                 4096, 6400, 12800, 25600, 51200, 65535, 65536, 100000, 1000000 };
+    for ( int32_t d : divisors ) checkDivisor( d );
+    for ( uint8_t i = 0; i < 40; i++ ) checkDivisor( 1 + sim::rand32() % 200000 );
+    printf( "%lu conversions checked, %lu deviations\n", (unsigned long)checks, (unsigned long)errors );
+    return errors ? 1 : 0;
+}
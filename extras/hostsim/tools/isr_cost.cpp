@@ -0,0 +1,64 @@
+// Runtime of the stepper ISR on the host for a normal move and for an endless rotation.
+// The tool is built for the default configuration ( isr_cost ) and with MOTO_POS64 ( isr_cost_pos64 ),
+// so the cost of the 64-bit position and of the 'endless' flag can be compared.
+// The runtimes are measured on the host processor and are only relative values: on the Arduino the
+// max. runtime of the IRQ is shown by MoToStats::maxIsrTics() ( e.g. in the STAT line of the sketch
+// examples/_Stepper/TestStepRampCom ).
+// usage: isr_cost [runs]
+#include <MobaTools.h>
+#include <algorithm>
+#include "simcore.h"
+
+const uint8_t stepPin = 2, dirPin = 3;
+const uint32_t SPEED = 20000;           // steps/10sec: a step every 500µs
+const uint32_t MEASURETIME = 2000;      // ms per run, at constant speed
+
+MoToStepper stepper( 800, STEPDIR );
+static uint32_t steps = 0;
+
+static void countSteps( uint8_t pin, uint8_t level, sim::tick_t ) {
+    if ( pin == stepPin && level ) steps++;
+}
+
+// mean runtime per ISR and per step in ns while cruising
+static void measure( bool endless, double &perIsr, double &perStep ) {
+    stepper.setZero();
+    if ( endless ) stepper.rotate( 1 );
+    else stepper.moveTo( 1000000 );
+    sim::runMs( 500 );                  // ramp
+    uint32_t isrs = sim::isrCount( sim::COMPB );
+    uint64_t ns = sim::isrHostNs( sim::COMPB );
+    uint32_t startSteps = steps;
+    sim::runMs( MEASURETIME );
+    isrs = sim::isrCount( sim::COMPB ) - isrs;
+    ns = sim::isrHostNs( sim::COMPB ) - ns;
+    perIsr = (double)ns / isrs;
+    perStep = (double)ns / ( steps - startSteps );
+    stepper.stop();
+    sim::runMs( 10 );
+}
+
+int main( int argc, char *argv[] ) {
+    int runs = argc > 1 ? atoi( argv[1] ) : 5;
+    sim::onEdge( countSteps );
+    stepper.attach( stepPin, dirPin );
+    stepper.setSpeedSteps( SPEED, 500 );
+    // the fastest of all runs is the least disturbed by the host
+    double best[2][2] = { { 1e9, 1e9 }, { 1e9, 1e9 } };
+    for ( int r = 0; r < runs; r++ ) {
+        for ( int endless = 0; endless < 2; endless++ ) {
+            double perIsr, perStep;
+            measure( endless, perIsr, perStep );
+            best[endless][0] = std::min( best[endless][0], perIsr );
+            best[endless][1] = std::min( best[endless][1], perStep );
+        }
+    }
+    #ifdef MOTO_POS64
+    const char *config = "MOTO_POS64";
+    #else
+    const char *config = "default";
+    #endif
+    printf( "%-10s moveTo:  %6.1f ns/ISR  %6.1f ns/step\n", config, best[0][0], best[0][1] );
+    printf( "%-10s rotate:  %6.1f ns/ISR  %6.1f ns/step\n", config, best[1][0], best[1][1] );
+    return 0;
+}
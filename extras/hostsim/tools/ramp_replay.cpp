@@ -0,0 +1,178 @@
+// Replay the command scripts of examples/_Stepper/TestStepRampCom on the simulated timer.
+// The sketch runs unchanged: the 'eep' lines of the script are sent over the simulated serial
+// interface, then every sequence ( first index of a block ) is started with 'est' and the
+// STAT line of the sketch is collected at its end ( see stepStats.h ).
+// usage: ramp_replay [-v] [-u] <testcommands.txt> [<baseline>]
+//   -v  show the output of the sketch
+//   -u  write the results as new baseline
+// Without -u the results are compared with the baseline, the exit code is 1 if a value is worse:
+//   vmax, ramp and time must be the same ( tolerance 1% ), over, late and lateMax must not be higher.
+#include <MobaTools.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "simcore.h"
+
+void setup();
+void loop();
+extern MoToStepper myStepper;
+
+const uint32_t LOOPTIME = 100;          // simulated runtime of loop() in µs
+const uint32_t SEQTIMEOUT = 120000;     // max. runtime of a sequence in ms
+
+static bool verbose = false;
+static std::string outLine;
+static std::string statLine;            // last STAT line of the sketch
+
+static void serialOut( char c ) {
+    if ( verbose ) putchar( c );
+    if ( c == '\n' || c == '\r' ) {
+        if ( outLine.compare( 0, 5, "STAT " ) == 0 ) statLine = outLine;
+        outLine.clear();
+    } else {
+        outLine += c;
+    }
+}
+
+static void runLoop() {
+    loop();
+    sim::runUs( LOOPTIME );
+}
+
+static void sendLine( const std::string &line ) {
+    sim::serialInput( ( line + "\n" ).c_str() );
+    // the sketch reads all available data in one loop()
+    while ( Serial.available() ) runLoop();
+    runLoop();
+}
+
+typedef std::map<std::string, long> result_t;     // name -> value
+
+static result_t parseValues( const std::string &text ) {
+    result_t res;
+    size_t pos = 0;
+    while ( ( pos = text.find( '=', pos ) ) != std::string::npos ) {
+        size_t start = text.rfind( ' ', pos );
+        start = start == std::string::npos ? 0 : start + 1;
+        res[text.substr( start, pos - start )] = atol( text.c_str() + pos + 1 );
+        pos++;
+    }
+    return res;
+}
+
+static bool worse( const std::string &name, long value, long base ) {
+    if ( name == "vmax" || name == "ramp" || name == "time" ) {
+        return labs( value - base ) > ( labs( base ) / 100 > 1 ? labs( base ) / 100 : 1 );
+    }
+    if ( name == "over" || name == "late" || name == "lateMax" ) return value > base;
+    return false;       // only informative ( e.g. isrMax, which is not simulated )
+}
+
+int main( int argc, char *argv[] ) {
+    bool update = false;
+    int arg = 1;
+    for ( ; arg < argc && argv[arg][0] == '-'; arg++ ) {
+        if ( strcmp( argv[arg], "-v" ) == 0 ) verbose = true;
+        else if ( strcmp( argv[arg], "-u" ) == 0 ) update = true;
+    }
+    if ( arg >= argc || ( update && arg + 1 >= argc ) ) {
+        fprintf( stderr, "usage: %s [-v] [-u] <testcommands.txt> [<baseline>]\n", argv[0] );
+        return 2;
+    }
+    FILE *cmdFile = fopen( argv[arg], "r" );
+    if ( cmdFile == nullptr ) {
+        fprintf( stderr, "cannot open %s\n", argv[arg] );
+        return 2;
+    }
+    const char *baseName = arg + 1 < argc ? argv[arg + 1] : nullptr;
+
+    sim::onSerialOutput( serialOut );
+    setup();
+
+    // store the script in the EEPROM of the sketch, a sequence starts with the first entry of a block
+    std::vector<int> sequences;
+    bool newBlock = true;
+    char buf[120];
+    while ( fgets( buf, sizeof(buf), cmdFile ) ) {
+        std::string line( buf );
+        while ( !line.empty() && isspace( line.back() ) ) line.pop_back();
+        if ( line.compare( 0, 4, "----" ) == 0 ) newBlock = true;
+        if ( line.compare( 0, 3, "eep" ) != 0 ) continue;
+        if ( newBlock ) sequences.push_back( atoi( line.c_str() + 3 ) );
+        newBlock = false;
+        sendLine( line );
+    }
+    fclose( cmdFile );
+
+    std::vector<std::string> results;
+    for ( int seq : sequences ) {
+        statLine.clear();
+        sim::tick_t start = sim::now();
+        sendLine( "est " + std::to_string( seq ) );
+        uint32_t hostIsrs = sim::isrCount( sim::COMPB );
+        uint64_t hostNs = sim::isrHostNs( sim::COMPB );
+        while ( statLine.empty() && sim::now() - start < (sim::tick_t)SEQTIMEOUT * 1000 * sim::TICS_PER_US ) {
+            runLoop();
+        }
+        if ( statLine.empty() ) {
+            printf( "seq %d: no result after %lu ms\n", seq, (unsigned long)SEQTIMEOUT );
+            return 1;
+        }
+        hostIsrs = sim::isrCount( sim::COMPB ) - hostIsrs;
+        hostNs = sim::isrHostNs( sim::COMPB ) - hostNs;
+        char res[200];
+        snprintf( res, sizeof(res), "seq=%d %s time=%lu", seq, statLine.c_str() + 5,
+                  (unsigned long)( ( sim::now() - start ) / ( 1000 * sim::TICS_PER_US ) ) );
+        results.push_back( res );
+        printf( "%s  ( host: %.0f ns per ISR )\n", res, hostIsrs ? (double)hostNs / hostIsrs : 0.0 );
+        // the stepper must stand still before the next sequence is started
+        start = sim::now();
+        while ( myStepper.getSpeedSteps() != 0 && sim::now() - start < (sim::tick_t)SEQTIMEOUT * 1000 * sim::TICS_PER_US ) {
+            runLoop();
+        }
+    }
+
+    if ( baseName == nullptr ) return 0;
+    if ( update ) {
+        FILE *f = fopen( baseName, "w" );
+        if ( f == nullptr ) {
+            fprintf( stderr, "cannot create %s\n", baseName );
+            return 2;
+        }
+        for ( auto &r : results ) fprintf( f, "%s\n", r.c_str() );
+        fclose( f );
+        printf( "baseline %s written\n", baseName );
+        return 0;
+    }
+
+    // compare with the baseline
+    std::map<long, result_t> base;
+    FILE *f = fopen( baseName, "r" );
+    if ( f == nullptr ) {
+        fprintf( stderr, "cannot open %s\n", baseName );
+        return 2;
+    }
+    while ( fgets( buf, sizeof(buf), f ) ) {
+        result_t r = parseValues( buf );
+        if ( r.count( "seq" ) ) base[r["seq"]] = r;
+    }
+    fclose( f );
+    bool regression = false;
+    for ( auto &line : results ) {
+        result_t r = parseValues( line );
+        auto b = base.find( r["seq"] );
+        if ( b == base.end() ) {
+            printf( "seq %ld: not in baseline\n", r["seq"] );
+            regression = true;
+            continue;
+        }
+        for ( auto &v : r ) {
+            if ( b->second.count( v.first ) && worse( v.first, v.second, b->second[v.first] ) ) {
+                printf( "seq %ld: %s=%ld, baseline %ld\n", r["seq"], v.first.c_str(), v.second, b->second[v.first] );
+                regression = true;
+            }
+        }
+    }
+    printf( regression ? "REGRESSION against %s\n" : "no regression against %s\n", baseName );
+    return regression ? 1 : 0;
+}
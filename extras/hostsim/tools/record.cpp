@@ -0,0 +1,76 @@
+// Record the pin changes of stepperISR, ISR_Servo and softledISR in a fixed scenario as VCD file.
+// usage: record <file.vcd> [max. random latency of the timer IRQs in tics]
+// Two recordings ( e.g. before and after a change of the library ) are compared with vcddiff.
+#include <MobaTools.h>
+#include "simcore.h"
+#include "vcd.h"
+
+const uint8_t stepPin = 2, dirPin = 3;
+const uint8_t servoPins[] = { 8, 9, 10, 11 };
+const uint8_t ledPins[] = { A0, A1, A2 };
+
+MoToStepper stepper( 800, STEPDIR );
+MoToServo servo[4];
+MoToSoftLed led[3];
+
+int main( int argc, char *argv[] ) {
+    if ( argc < 2 ) {
+        fprintf( stderr, "usage: %s <file.vcd> [max. latency ( tics )]\n", argv[0] );
+        return 2;
+    }
+    if ( argc > 2 ) {
+        uint16_t randMax = atoi( argv[2] );
+        for ( uint8_t v = 0; v < sim::VECTORS; v++ ) {
+            sim::latency_t lat = sim::getLatency( (sim::vector_t)v );
+            lat.randMax = randMax;
+            sim::setLatency( (sim::vector_t)v, lat );
+        }
+    }
+    sim::vcdPin( stepPin, "step" );
+    sim::vcdPin( dirPin, "dir" );
+    sim::vcdPin( servoPins[0], "servo0" );
+    sim::vcdPin( servoPins[1], "servo1" );
+    sim::vcdPin( servoPins[2], "servo2" );
+    sim::vcdPin( servoPins[3], "servo3" );
+    sim::vcdPin( ledPins[0], "led0" );
+    sim::vcdPin( ledPins[1], "led1" );
+    sim::vcdPin( ledPins[2], "led2" );
+    if ( !sim::vcdOpen( argv[1] ) ) {
+        fprintf( stderr, "cannot create %s\n", argv[1] );
+        return 1;
+    }
+
+    // --------- setup --------------
+    stepper.attach( stepPin, dirPin );
+    stepper.setSpeedSteps( 20000, 200 );
+    for ( uint8_t i = 0; i < 4; i++ ) {
+        servo[i].attach( servoPins[i] );
+        servo[i].setSpeed( 10 );
+        servo[i].write( 45 * i );
+    }
+    for ( uint8_t i = 0; i < 3; i++ ) {
+        led[i].attach( ledPins[i] );
+        led[i].riseTime( 100 * ( i + 1 ) );
+    }
+    sim::runMs( 100 );
+
+    // --------- scenario ------------
+    stepper.moveTo( 1000 );
+    led[0].on();
+    led[1].on( 50 );
+    for ( uint8_t i = 0; i < 4; i++ ) servo[i].write( 180 - 45 * i );
+    sim::runMs( 300 );
+    stepper.moveTo( -500 );         // reverse while moving
+    led[0].off();
+    led[2].on();
+    sim::runMs( 700 );
+    stepper.rotate( 1 );
+    servo[1].write( 90 );
+    led[1].write( OFF, LINEAR );
+    sim::runMs( 500 );
+    stepper.stop();
+    sim::runMs( 200 );
+
+    sim::vcdClose();
+    return 0;
+}
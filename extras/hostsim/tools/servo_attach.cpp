@@ -0,0 +1,101 @@
+// Check detach() and attach() of a servo while its pulse is running. attach() must not wait for the
+// end of a pending detach: the last pulse at the old pin must keep its full length, the old pin is
+// released afterwards ( INPUT ), and the new pin creates only pulses of the new position. A pulse,
+// that has been computed before the detach but not yet started, must not appear at the new pin.
+// exit code: 0 = ok, 1 = error
+#include <MobaTools.h>
+#include <vector>
+#include "simcore.h"
+
+const uint16_t POS_OLD = 2000;          // µs
+const uint32_t WINDOW = 200;            // ms of pulses after attach
+
+MoToServo servo[3];
+
+struct pinStat_t {
+    sim::tick_t riseTime = 0;
+    std::vector<uint32_t> lengths;      // pulse lengths in tics
+};
+static pinStat_t stat[NUM_DIGITAL_PINS];
+static bool error = false;
+
+static void pulseEdge( uint8_t pin, uint8_t level, sim::tick_t time ) {
+    if ( level ) stat[pin].riseTime = time;
+    else if ( stat[pin].riseTime > 0 ) stat[pin].lengths.push_back( time - stat[pin].riseTime );
+}
+
+static void clearStats() {
+    for ( uint8_t p = 0; p < NUM_DIGITAL_PINS; p++ ) stat[p].lengths.clear();
+}
+
+// run until a pulse starts at pin
+static void runUntilRise( uint8_t pin ) {
+    for ( uint32_t us = 0; us < 2 * SERVO_CYCLETIME && !sim::pinLevel( pin ); us++ ) sim::runUs( 1 );
+}
+
+// all pulses at pin must have the length of pos ( µs ), at least minPulses
+static void expectPulses( const char *what, uint8_t pin, uint16_t pos, uint32_t minPulses ) {
+    uint32_t bad = 0;
+    for ( uint32_t len : stat[pin].lengths ) {
+        if ( abs( (int32_t)len - (int32_t)pos * sim::TICS_PER_US ) > 1 ) bad++;
+    }
+    bool ok = bad == 0 && stat[pin].lengths.size() >= minPulses;
+    printf( "%-40s pin %u: %3u pulses of %uus, %u other%s\n", what, pin, (unsigned)stat[pin].lengths.size(), pos, bad,
+            ok ? "" : "  <-- ERROR" );
+    error |= !ok;
+}
+
+static void expectReleased( const char *what, uint8_t pin ) {
+    bool ok = !( DDRD & digitalPinToBitMask( pin ) ) && !sim::pinLevel( pin );
+    printf( "%-40s pin %u: %s%s\n", what, pin, ok ? "released" : "still output or high", ok ? "" : "  <-- ERROR" );
+    error |= !ok;
+}
+
+int main() {
+    sim::onEdge( pulseEdge );
+    // the servo chain starts with the servo created last: the pulse of servo 2 starts first,
+    // servo 1 is the next one ( with the same length it must wait for OFFMARGIN )
+    servo[0].attach( 2 );
+    servo[1].attach( 4 );
+    servo[2].attach( 5 );
+    for ( MoToServo &s : servo ) s.write( POS_OLD );
+    sim::runMs( 500 );
+
+    // servo 0 moves to another pin during its pulse
+    runUntilRise( 2 );
+    sim::runUs( 500 );
+    clearStats();
+    servo[0].detach();
+    servo[0].attach( 3 );
+    servo[0].write( 1000 );
+    sim::runMs( WINDOW );
+    expectPulses( "servo 0 -> pin 3: last pulse at old pin", 2, POS_OLD, 1 );
+    expectReleased( "servo 0 -> pin 3: old pin", 2 );
+    expectPulses( "servo 0 -> pin 3: new pin", 3, 1000, WINDOW * 1000 / SERVO_CYCLETIME - 1 );
+
+    // servo 0 is attached to the same pin again during its pulse
+    runUntilRise( 3 );
+    sim::runUs( 300 );
+    clearStats();
+    servo[0].detach();
+    servo[0].attach( 3 );
+    sim::runMs( 2 );
+    expectPulses( "servo 0 -> pin 3 again: last pulse", 3, 1000, 1 );
+    clearStats();
+    servo[0].write( 1500 );
+    sim::runMs( WINDOW );
+    expectPulses( "servo 0 -> pin 3 again: new position", 3, 1500, WINDOW * 1000 / SERVO_CYCLETIME - 1 );
+
+    // servo 1 moves to another pin while its next pulse is waiting to be started
+    runUntilRise( 5 );
+    clearStats();
+    servo[1].detach();
+    servo[1].attach( 6 );
+    servo[1].write( 1000 );
+    sim::runMs( WINDOW );
+    expectPulses( "servo 1 -> pin 6: old pin", 4, POS_OLD, 0 );
+    expectReleased( "servo 1 -> pin 6: old pin", 4 );
+    expectPulses( "servo 1 -> pin 6: new pin", 6, 1000, WINDOW * 1000 / SERVO_CYCLETIME - 1 );
+    expectPulses( "servo 2 unchanged", 5, POS_OLD, WINDOW * 1000 / SERVO_CYCLETIME - 1 );
+    return error ? 1 : 0;
+}
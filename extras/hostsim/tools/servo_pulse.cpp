@@ -0,0 +1,135 @@
+// Check the length of the servo pulses created by ISR_Servo.
+// MAX_SERVOS servos are attached to the pins 2, 3 ... ( max. 18 on the Uno, 63 with SIM_MEGA ). The
+// servos with an even index stand still at fixed positions ( partly with the same pulse length ), the
+// others move back and forth with different speeds, so the pulses are overlapping in always changing
+// combinations. With -w all servos stand at MAXPULSEWIDTH, the worst case for SERVO_OVERLAP.
+// The length of every pulse of the standing servos is compared with the set position. Without
+// injected latency it must not deviate more than 1 timer tic. Every servo must create a pulse in every
+// cycle. The max. period between 2 pulses of a servo is printed: with moving servos the pulses are
+// shifted within the cycle, with -w the period must not exceed SERVO_CYCLETIME ( + tolerance ).
+// The tool is built for several servo configurations ( see Makefile ).
+// usage: servo_pulse [-v] [-w] [-l <randMax>] [-f <fixed>] [-c <cost>] [-t <tolerance>]
+//   -v  print the statistics of every servo
+//   -w  all servos stand at MAXPULSEWIDTH
+//   -l, -f, -c  latency of the servo IRQ in tics ( see sim::latency_t ): random delay 0..randMax,
+//       fixed delay, runtime of the ISR
+//   -t  max. allowed deviation of a pulse in tics ( default 1 )
+// For every standing servo the distribution of the pulse length error is printed ( with -v or if a
+// pulse deviates more than the tolerance ).
+// exit code: 0 = all pulses within the tolerance, 1 = deviations or missing pulses
+#include <MobaTools.h>
+#include <vector>
+#include <algorithm>
+#include "simcore.h"
+
+const uint8_t firstPin = 2;
+const uint8_t SERVOS = MAX_SERVOS < NUM_DIGITAL_PINS - firstPin ? MAX_SERVOS : NUM_DIGITAL_PINS - firstPin;
+const uint32_t SETTLETIME = 1000;       // ms until the standing servos have reached their position
+const uint32_t MEASURETIME = 3000;      // ms
+
+// positions of the standing servos in µs
+const uint16_t standPos[] = { 700, 700, 1500, 2300, 1001, 1500, 1999, 2300 };
+
+MoToServo servo[SERVOS];
+
+struct pulseStat_t {
+    sim::tick_t riseTime = 0;
+    uint32_t maxPeriod = 0;         // max. time between 2 pulses in tics
+    uint16_t expected = 0;          // pulse length in tics ( 0: servo is moving )
+    uint32_t pulses = 0;
+    std::vector<int32_t> errors;    // pulse length errors in tics ( standing servos )
+};
+static pulseStat_t stat[SERVOS];
+static bool measuring = false;
+
+static void pulseEdge( uint8_t pin, uint8_t level, sim::tick_t time ) {
+    if ( !measuring || pin < firstPin || pin >= firstPin + SERVOS ) return;
+    pulseStat_t &s = stat[pin - firstPin];
+    if ( level ) {
+        if ( s.riseTime > 0 && time - s.riseTime > s.maxPeriod ) s.maxPeriod = time - s.riseTime;
+        s.riseTime = time;
+    } else if ( s.riseTime > 0 ) {
+        s.pulses++;
+        if ( s.expected ) s.errors.push_back( (int32_t)( time - s.riseTime ) - s.expected );
+    }
+}
+
+// error at a fraction of the sorted errors
+static int32_t percentile( const std::vector<int32_t> &sorted, uint8_t percent ) {
+    return sorted[( sorted.size() - 1 ) * percent / 100];
+}
+
+int main( int argc, char *argv[] ) {
+    bool verbose = false, worstCase = false;
+    int32_t tolerance = 1;
+    sim::latency_t lat = sim::getLatency( sim::COMPA );
+    for ( int arg = 1; arg < argc; arg++ ) {
+        if ( strcmp( argv[arg], "-v" ) == 0 ) verbose = true;
+        else if ( strcmp( argv[arg], "-w" ) == 0 ) worstCase = true;
+        else if ( arg + 1 < argc && strcmp( argv[arg], "-l" ) == 0 ) lat.randMax = atoi( argv[++arg] );
+        else if ( arg + 1 < argc && strcmp( argv[arg], "-f" ) == 0 ) lat.fixed = atoi( argv[++arg] );
+        else if ( arg + 1 < argc && strcmp( argv[arg], "-c" ) == 0 ) lat.cost = atoi( argv[++arg] );
+        else if ( arg + 1 < argc && strcmp( argv[arg], "-t" ) == 0 ) tolerance = atoi( argv[++arg] );
+        else {
+            fprintf( stderr, "usage: %s [-v] [-w] [-l <randMax>] [-f <fixed>] [-c <cost>] [-t <tolerance>]\n", argv[0] );
+            return 2;
+        }
+    }
+    sim::setLatency( sim::COMPA, lat );
+    sim::onEdge( pulseEdge );
+    for ( uint8_t i = 0; i < SERVOS; i++ ) {
+        servo[i].attach( firstPin + i );
+        if ( worstCase || i % 2 == 0 ) {
+            uint16_t pos = worstCase ? MAXPULSEWIDTH : standPos[i / 2 % 8];
+            servo[i].write( pos );
+            stat[i].expected = pos * sim::TICS_PER_US;
+        } else {
+            servo[i].setSpeed( 5 + 7 * i );
+            servo[i].write( MINPULSEWIDTH );
+        }
+    }
+    sim::runMs( SETTLETIME );
+    measuring = true;
+    for ( uint32_t t = 0; t < MEASURETIME; t += 10 ) {
+        // moving servos turn at the end positions
+        for ( uint8_t i = 1; i < SERVOS && !worstCase; i += 2 ) {
+            if ( !servo[i].moving() ) servo[i].write( servo[i].readMicroseconds() < 1500 ? MAXPULSEWIDTH : MINPULSEWIDTH );
+        }
+        sim::runMs( 10 );
+    }
+    measuring = false;
+
+    // every servo must have created a pulse in every cycle ( the first may be incomplete )
+    const uint32_t minPulses = MEASURETIME * 1000UL / SERVO_CYCLETIME - 1;
+    bool error = false;
+    int32_t minErr = INT32_MAX, maxErr = INT32_MIN;
+    uint32_t maxPeriod = 0;
+    const uint32_t cycleTics = SERVO_CYCLETIME * sim::TICS_PER_US;
+    if ( verbose ) printf( "servo  pulses  period  length    min    p10    p50    p90    p99    max  >tolerance\n" );
+    for ( uint8_t i = 0; i < SERVOS; i++ ) {
+        pulseStat_t &s = stat[i];
+        bool bad = s.pulses < minPulses || ( worstCase && s.maxPeriod > cycleTics + tolerance );
+        maxPeriod = std::max( maxPeriod, s.maxPeriod );
+        if ( s.expected && !s.errors.empty() ) {
+            std::vector<int32_t> &e = s.errors;
+            std::sort( e.begin(), e.end() );
+            uint32_t outside = std::count_if( e.begin(), e.end(), [=]( int32_t x ) { return abs( x ) > tolerance; } );
+            bad |= outside > 0;
+            minErr = std::min( minErr, e.front() );
+            maxErr = std::max( maxErr, e.back() );
+            if ( verbose || bad ) {
+                printf( "%5u  %6u  %+6d  %4uus %6d %6d %6d %6d %6d %6d  %u%s\n", i, s.pulses,
+                        (int32_t)( s.maxPeriod - cycleTics ), s.expected / sim::TICS_PER_US,
+                        e.front(), percentile( e, 10 ), percentile( e, 50 ), percentile( e, 90 ), percentile( e, 99 ),
+                        e.back(), outside, bad ? "  <--" : "" );
+            }
+        } else if ( verbose || bad ) {
+            printf( "%5u  %6u  %+6d  moving%s\n", i, s.pulses, (int32_t)( s.maxPeriod - cycleTics ), bad ? "  <--" : "" );
+        }
+        error |= bad;
+    }
+    printf( "%u servos, SERVO_OVERLAP %u, cycle %uus, latency %u+0..%u tics: pulse error of the standing servos "
+            "%+d..%+d tics, max. period %+d tics%s\n", SERVOS, SERVO_OVERLAP, SERVO_CYCLETIME, lat.fixed, lat.randMax,
+            minErr, maxErr, (int32_t)( maxPeriod - cycleTics ), error ? ", ERROR" : "" );
+    return error ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+// MoToServo::write( angle ): resulting pulse lengths and runtime on the host.
+// write() converts degrees with a precomputed slope ( multiplication and shift ). Up to V2.6.1 it used
+// map() with a 32-bit division, which truncated the pulse length to whole µs. The tool sets all angles
+// 0..180 for several pulse ranges, measures the created pulses and shows the difference to the former
+// conversion ( in timer tics of 0.5µs ) and the max. deviation from the exact value.
+// Then it measures the runtime of write() on the host. On the host a division is cheap, so the result
+// is only a relative value: on AVR the former conversion needed a 32-bit division ( several hundred
+// cycles ).
+// usage: servo_write [nbr of writes for the runtime measurement]
+// exit code: 1 if a pulse deviates more than 1 tic from the exact value
+#include <MobaTools.h>
+#include <time.h>
+#include <math.h>
+#include <map>
+#include "simcore.h"
+
+struct range_t { uint16_t minPw, maxPw; };
+const range_t ranges[] = { { MINPULSEWIDTH, MAXPULSEWIDTH }, { 1000, 2000 }, { 1000, 1999 }, { 2000, 1000 } };
+const uint8_t RANGES = sizeof( ranges ) / sizeof( ranges[0] );
+const uint8_t firstPin = 2;
+
+MoToServo servo[RANGES];
+static sim::tick_t riseTime[RANGES];
+static uint16_t pulseLen[RANGES];       // last pulse length in tics
+
+static void pulseEdge( uint8_t pin, uint8_t level, sim::tick_t time ) {
+    if ( pin < firstPin || pin >= firstPin + RANGES ) return;
+    if ( level ) riseTime[pin - firstPin] = time;
+    else pulseLen[pin - firstPin] = time - riseTime[pin - firstPin];
+}
+
+// the former conversion of write(), in tics of the timer
+static uint16_t formerTics( uint8_t angle, const range_t &r ) {
+    return map( angle, 0, 180, r.minPw, r.maxPw ) * sim::TICS_PER_US;    // whole µs
+}
+
+static double nsSince( const timespec &start ) {
+    timespec end;
+    clock_gettime( CLOCK_MONOTONIC, &end );
+    return ( end.tv_sec - start.tv_sec ) * 1e9 + ( end.tv_nsec - start.tv_nsec );
+}
+
+int main( int argc, char *argv[] ) {
+    long writes = argc > 1 ? atol( argv[1] ) : 2000000;
+    sim::onEdge( pulseEdge );
+    for ( uint8_t i = 0; i < RANGES; i++ ) {
+        servo[i].attach( firstPin + i, ranges[i].minPw, ranges[i].maxPw );
+        servo[i].setSpeed( 0 );         // move immediately
+    }
+
+    // ---------- pulse lengths -----------------------------------------------
+    bool error = false;
+    for ( uint8_t i = 0; i < RANGES; i++ ) {
+        std::map<int, int> diffCount;   // new - former ( tics ) -> nbr of angles
+        double maxDev = 0;
+        for ( uint8_t angle = 0; angle <= 180; angle++ ) {
+            servo[i].write( angle );
+            sim::runUs( 2 * SERVO_CYCLETIME );
+            double exact = ( ranges[i].minPw + angle * ( (double)ranges[i].maxPw - ranges[i].minPw ) / 180 )
+                           * sim::TICS_PER_US;
+            double dev = fabs( pulseLen[i] - exact );
+            if ( dev > maxDev ) maxDev = dev;
+            diffCount[pulseLen[i] - formerTics( angle, ranges[i] )]++;
+        }
+        printf( "range %4u..%4uus: max. deviation from exact %.2f tics, difference to former write():",
+                ranges[i].minPw, ranges[i].maxPw, maxDev );
+        for ( auto &d : diffCount ) printf( "  %+d tics: %d", d.first, d.second );
+        printf( "\n" );
+        if ( maxDev > 1 ) error = true;
+    }
+
+    // ---------- runtime ----------------------------------------------------
+    timespec start;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    for ( long n = 0; n < writes; n++ ) servo[0].write( n % 181 );
+    double writeNs = nsSince( start ) / writes;
+    volatile uint16_t sink;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    for ( long n = 0; n < writes; n++ ) sink = formerTics( n % 181, ranges[n & 3] );
+    double formerNs = nsSince( start ) / writes;
+    (void)sink;
+    printf( "host: write( angle ) %.1f ns, former conversion alone %.1f ns\n", writeNs, formerNs );
+    return error ? 1 : 0;
+}
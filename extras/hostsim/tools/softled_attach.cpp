@@ -0,0 +1,89 @@
+// Check re-attaching softleds to another pin. The leds are grouped by ports ( ledPort_t ), a led that
+// moves to another port must leave the record of its old port, and its old pin must not be driven
+// by the ISR anymore. The tool is built without and with SOFTLED_BAM.
+// exit code: 0 = ok, 1 = error
+#include <MobaTools.h>
+#include "simcore.h"
+
+const uint32_t WINDOW = 200;            // ms for the measurement of the pin levels
+
+MoToSoftLed led[4];
+
+static sim::tick_t highTime[NUM_DIGITAL_PINS], lastEdge[NUM_DIGITAL_PINS];
+static uint32_t edges[NUM_DIGITAL_PINS];
+static bool error = false;
+
+static void pinEdge( uint8_t pin, uint8_t level, sim::tick_t time ) {
+    if ( !level ) highTime[pin] += time - lastEdge[pin];
+    lastEdge[pin] = time;
+    edges[pin]++;
+}
+
+// run for WINDOW ms and measure the time the pins are high
+static void runWindow() {
+    for ( uint8_t p = 0; p < NUM_DIGITAL_PINS; p++ ) {
+        highTime[p] = 0;
+        lastEdge[p] = sim::now();
+        edges[p] = 0;
+    }
+    sim::runMs( WINDOW );
+    for ( uint8_t p = 0; p < NUM_DIGITAL_PINS; p++ ) {
+        if ( sim::pinLevel( p ) ) highTime[p] += sim::now() - lastEdge[p];
+    }
+}
+
+static void expect( const char *what, uint8_t pin, uint8_t percent ) {
+    uint32_t high = highTime[pin] * 100 / ( (sim::tick_t)WINDOW * 1000 * sim::TICS_PER_US );
+    bool ok = high == percent && ( percent == 0 || percent == 100 ? edges[pin] == 0 : true );
+    printf( "%-36s pin %2u: %3u%% high, %u edges%s\n", what, pin, high, edges[pin], ok ? "" : "  <-- ERROR" );
+    error |= !ok;
+}
+
+static void expectAttach( const char *what, uint8_t result, uint8_t expected ) {
+    printf( "%-36s %s%s\n", what, result ? "attached" : "refused", result == expected ? "" : "  <-- ERROR" );
+    error |= result != expected;
+}
+
+int main() {
+    sim::onEdge( pinEdge );
+    // port C: led 0 ( owns the port record ) and led 1, port B: led 2
+    expectAttach( "led 0 -> A0", led[0].attach( A0 ), true );
+    expectAttach( "led 1 -> A1", led[1].attach( A1 ), true );
+    expectAttach( "led 2 -> 8", led[2].attach( 8 ), true );
+    for ( uint8_t i = 0; i < 3; i++ ) {
+        led[i].riseTime( 50 );
+        led[i].on();
+    }
+    sim::runMs( 200 );
+    runWindow();
+    expect( "all on", A0, 100 );
+
+    // led 0 moves to port B, which has a record. Its old pin must be switched off
+    expectAttach( "led 0 -> 9 ( port B )", led[0].attach( 9 ), true );
+    led[0].riseTime( 50 );
+    led[0].on();
+    sim::runMs( 200 );
+    runWindow();
+    expect( "led 0 moved: old pin", A0, 0 );
+    expect( "led 0 moved: new pin", 9, 100 );
+    expect( "led 1 stays on port C", A1, 100 );
+
+    // the record of led 0 is still used by led 1 ( port C ), so led 0 cannot open a new port
+    expectAttach( "led 0 -> 2 ( port D, no record )", led[0].attach( 2 ), false );
+    // led 1 can: its own record is free
+    expectAttach( "led 1 -> 2 ( port D, no record )", led[1].attach( 2 ), true );
+    led[1].riseTime( 50 );
+    led[1].on();
+    led[2].off();
+    led[3].attach( A2 );                // port C has no record anymore, led 3 uses its own
+    led[3].riseTime( 50 );
+    led[3].on();
+    sim::runMs( 200 );
+    runWindow();
+    expect( "led 1 moved: old pin", A1, 0 );
+    expect( "led 1 moved: new pin", 2, 100 );
+    expect( "led 0 still on port B", 9, 100 );
+    expect( "led 2 off", 8, 0 );
+    expect( "led 3 on port C", A2, 100 );
+    return error ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+// Runtime of the softled ISR on the host depending on the number of leds.
+// 1..16 softleds on the pins 2..17 ( ports D, B and C ) fade up and down continuously. The tool is built
+// for the default configuration ( softled_cost ) and with SOFTLED_BAM ( softled_cost_bam ).
+// The runtimes are measured on the host processor and are only relative values: on the Arduino the
+// max. runtime of the IRQ is shown by MoToStats::maxIsrTics().
+// usage: softled_cost [runs]
+#include <MobaTools.h>
+#include <algorithm>
+#include "simcore.h"
+
+const uint8_t LEDS = 16;
+const uint8_t firstPin = 2;
+const uint16_t RISETIME = 100;          // ms
+const uint32_t MEASURETIME = 1000;      // ms per run
+
+MoToSoftLed led[LEDS];
+
+// mean runtime per ISR in ns while the leds 0..n-1 are fading
+static double measure( uint8_t n ) {
+    for ( uint8_t i = 0; i < LEDS; i++ ) led[i].off();
+    sim::runMs( 2 * RISETIME );
+    uint32_t isrs = sim::isrCount( sim::COMPB );
+    uint64_t ns = sim::isrHostNs( sim::COMPB );
+    for ( uint32_t t = 0; t < MEASURETIME; t += RISETIME ) {
+        for ( uint8_t i = 0; i < n; i++ ) led[i].toggle();
+        sim::runMs( RISETIME );
+    }
+    isrs = sim::isrCount( sim::COMPB ) - isrs;
+    ns = sim::isrHostNs( sim::COMPB ) - ns;
+    return (double)ns / isrs;
+}
+
+int main( int argc, char *argv[] ) {
+    int runs = argc > 1 ? atoi( argv[1] ) : 3;
+    // the fastest of all runs is the least disturbed by the host
+    double best[LEDS];
+    std::fill( best, best + LEDS, 1e9 );
+    for ( uint8_t i = 0; i < LEDS; i++ ) {
+        led[i].attach( firstPin + i );
+        led[i].riseTime( RISETIME );
+    }
+    for ( int r = 0; r < runs; r++ ) {
+        for ( uint8_t n = 1; n <= LEDS; n++ ) {
+            best[n - 1] = std::min( best[n - 1], measure( n ) );
+        }
+    }
+    #ifdef SOFTLED_BAM
+    const char *config = "SOFTLED_BAM";
+    #else
+    const char *config = "default";
+    #endif
+    printf( "%-11s leds  ns/ISR  ns/ISR/led\n", config );
+    for ( uint8_t n = 1; n <= LEDS; n++ ) printf( "%-11s %4u  %6.1f  %10.1f\n", "", n, best[n - 1], best[n - 1] / n );
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Check the PWM period and the phase of staggered softleds. Every led starts its pulses at its own
+// phase within the PWM cycle ( LED_PHASE_STEP IRQ cycles after the led attached before ). The leds
+// are switched on together at different points of the PWM cycle and fade up: every rising edge,
+// including the first one after on(), must lie at the phase of the led within the PWM cycle, and
+// consecutive pulses of a led must be one PWM cycle apart. The phase is measured against the nearest
+// pulse of led 0 ( phase 0 ), because the PWM grid drifts against the simulated time: the AVR timer
+// period is ICR1+1 tics.
+// exit code: 0 = ok, 1 = error
+#include <MobaTools.h>
+#include <vector>
+#include "simcore.h"
+
+const uint8_t LEDS = 3;
+const uint8_t firstPin = 2;
+const uint16_t RISETIME = 400;          // ms
+const uint32_t ONTIME = 300;            // ms of fading up, that are checked
+const sim::tick_t PERIOD = (sim::tick_t)LED_FRAMETIME * sim::TICS_PER_US;
+const sim::tick_t PHASETICS = (sim::tick_t)LED_PHASE_STEP * CYCLETIME * sim::TICS_PER_US;
+const int32_t TOLERANCE = 2;            // tics
+
+MoToSoftLed led[LEDS];
+
+static std::vector<sim::tick_t> rises[LEDS];    // rising edges while the leds fade up
+static bool measuring = false;
+
+static void ledEdge( uint8_t pin, uint8_t level, sim::tick_t time ) {
+    if ( measuring && level && pin >= firstPin && pin < firstPin + LEDS ) rises[pin - firstPin].push_back( time );
+}
+
+// deviation of t from the phase of led ix, relative to the nearest pulse of led 0
+static int32_t phaseError( sim::tick_t t, uint8_t ix, const std::vector<sim::tick_t> &ref ) {
+    sim::tick_t r0 = ref[0];
+    for ( sim::tick_t r : ref ) {
+        if ( llabs( (int64_t)( t - r ) ) < llabs( (int64_t)( t - r0 ) ) ) r0 = r;
+    }
+    int64_t d = ( (int64_t)( t - r0 ) - (int64_t)( ix * PHASETICS ) ) % (int64_t)PERIOD;
+    if ( d < 0 ) d += PERIOD;
+    return d > (int64_t)PERIOD / 2 ? (int32_t)( d - PERIOD ) : (int32_t)d;
+}
+
+int main() {
+    sim::onEdge( ledEdge );
+    for ( uint8_t i = 0; i < LEDS; i++ ) {
+        led[i].attach( firstPin + i );
+        led[i].riseTime( RISETIME );
+    }
+
+    bool error = false;
+    printf( "PWM cycle %u tics, phase step %u tics\n", (unsigned)PERIOD, (unsigned)PHASETICS );
+    // switch on at different points of the PWM cycle
+    for ( uint8_t run = 0; run < 8; run++ ) {
+        sim::runUs( run * LED_FRAMETIME / 8 + 1000 );
+        for ( uint8_t i = 0; i < LEDS; i++ ) rises[i].clear();
+        sim::tick_t onTime = sim::now();
+        measuring = true;
+        for ( uint8_t i = 0; i < LEDS; i++ ) led[i].on();
+        sim::runMs( ONTIME );
+        measuring = false;
+        for ( uint8_t i = 0; i < LEDS; i++ ) led[i].off();
+        sim::runMs( 2 * RISETIME );
+
+        if ( rises[0].empty() ) {
+            printf( "no pulses of led 0  <-- ERROR\n" );
+            return 1;
+        }
+        for ( uint8_t i = 0; i < LEDS; i++ ) {
+            std::vector<sim::tick_t> &r = rises[i];
+            int32_t maxPhaseErr = 0, maxPeriodErr = 0;
+            for ( size_t n = 0; n < r.size(); n++ ) {
+                maxPhaseErr = std::max( maxPhaseErr, abs( phaseError( r[n], i, rises[0] ) ) );
+                if ( n > 0 ) maxPeriodErr = std::max( maxPeriodErr, abs( (int32_t)( r[n] - r[n-1] - PERIOD ) ) );
+            }
+            // the first pulse starts at the phase of the led in the next PWM cycle after on(). Its length
+            // may be 0, so the first edge may come one PWM cycle later
+            sim::tick_t first = r.empty() ? 0 : r[0] - onTime;
+            bool bad = r.size() < ONTIME * 1000 / LED_FRAMETIME - 3 || maxPhaseErr > TOLERANCE
+                       || maxPeriodErr > TOLERANCE || first > 2 * PERIOD + i * PHASETICS % PERIOD;
+            printf( "on at %+6d: led %u ( phase %5u ): %2u pulses, first after %6u tics, max. phase error %6d, "
+                    "max. period error %6d%s\n", phaseError( onTime, 0, rises[0] ), i, (unsigned)( i * PHASETICS % PERIOD ),
+                    (unsigned)r.size(), (unsigned)first, maxPhaseErr, maxPeriodErr, bad ? "  <-- ERROR" : "" );
+            error |= bad;
+        }
+    }
+    return error ? 1 : 0;
+}
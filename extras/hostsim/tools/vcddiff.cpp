@@ -0,0 +1,153 @@
+// Compare the pin changes of two VCD files ( e.g. recordings of the host simulation before and after
+// a change, or a recording of a logic analyzer ). The edges of signals with the same name are compared
+// in their order.
+// usage: vcddiff [-t <tolerance µs>] [-s <start µs>] <a.vcd> <b.vcd>
+//   -t  edges that are shifted more than this are reported as deviation ( default 0 )
+//   -s  ignore edges before this time ( default 0 )
+// For every signal it prints the number of edges, the max. and mean shift of the edges and the max.
+// change of the time between two edges ( pulse and pause lengths ).
+// exit code: 0 = no deviation beyond the tolerance, 1 = deviations found, 2 = error
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <map>
+
+struct edge_t {
+    double time;        // µs
+    char level;
+};
+
+struct signal_t {
+    std::string name;
+    char level = 'x';
+    std::vector<edge_t> edges;
+};
+
+typedef std::map<std::string, signal_t> signals_t;
+
+static bool nextToken( FILE *f, std::string &tok ) {
+    int c;
+    tok.clear();
+    while ( ( c = fgetc( f ) ) != EOF && isspace( c ) );
+    if ( c == EOF ) return false;
+    do tok += (char)c; while ( ( c = fgetc( f ) ) != EOF && !isspace( c ) );
+    return true;
+}
+
+static double unitFactor( const std::string &ts ) {
+    // timescale to µs
+    double num = atof( ts.c_str() );
+    if ( num == 0 ) num = 1;
+    if ( ts.find( "fs" ) != std::string::npos ) return num * 1e-9;
+    if ( ts.find( "ps" ) != std::string::npos ) return num * 1e-6;
+    if ( ts.find( "ns" ) != std::string::npos ) return num * 1e-3;
+    if ( ts.find( "us" ) != std::string::npos ) return num;
+    if ( ts.find( "ms" ) != std::string::npos ) return num * 1e3;
+    return num * 1e6;   // s
+}
+
+static bool readVcd( const char *fileName, signals_t &byName, double start ) {
+    FILE *f = fopen( fileName, "r" );
+    if ( f == nullptr ) {
+        fprintf( stderr, "cannot open %s\n", fileName );
+        return false;
+    }
+    std::map<std::string, std::string> idToName;
+    double factor = 1e-3;       // default timescale 1ns
+    double now = 0;
+    std::string tok;
+    while ( nextToken( f, tok ) ) {
+        if ( tok == "$timescale" ) {
+            std::string ts;
+            while ( nextToken( f, tok ) && tok != "$end" ) ts += tok;
+            factor = unitFactor( ts );
+        } else if ( tok == "$var" ) {
+            std::vector<std::string> v;
+            while ( nextToken( f, tok ) && tok != "$end" ) v.push_back( tok );
+            // type size id name [range]
+            if ( v.size() >= 4 && v[1] == "1" ) {
+                idToName[v[2]] = v[3];
+                byName[v[3]].name = v[3];
+            }
+        } else if ( tok[0] == '$' ) {
+            // other sections are skipped, but $dumpvars contains values
+            if ( tok != "$dumpvars" && tok != "$end" ) {
+                while ( nextToken( f, tok ) && tok != "$end" );
+            }
+        } else if ( tok[0] == '#' ) {
+            now = atof( tok.c_str() + 1 ) * factor;
+        } else if ( strchr( "01xXzZ", tok[0] ) ) {
+            auto id = idToName.find( tok.substr( 1 ) );
+            if ( id == idToName.end() ) continue;
+            signal_t &s = byName[id->second];
+            if ( tok[0] == s.level ) continue;
+            // the first value of a signal is its initial level, not an edge
+            if ( s.level != 'x' && now >= start ) s.edges.push_back( { now, tok[0] } );
+            s.level = tok[0];
+        }
+        // vector values ( b... ) and real values are ignored
+    }
+    fclose( f );
+    return true;
+}
+
+int main( int argc, char *argv[] ) {
+    double tolerance = 0, start = 0;
+    int opt = 1;
+    while ( opt < argc - 2 ) {
+        if ( strcmp( argv[opt], "-t" ) == 0 ) tolerance = atof( argv[opt + 1] );
+        else if ( strcmp( argv[opt], "-s" ) == 0 ) start = atof( argv[opt + 1] );
+        else break;
+        opt += 2;
+    }
+    if ( argc - opt != 2 ) {
+        fprintf( stderr, "usage: %s [-t <tolerance us>] [-s <start us>] <a.vcd> <b.vcd>\n", argv[0] );
+        return 2;
+    }
+    signals_t a, b;
+    if ( !readVcd( argv[opt], a, start ) || !readVcd( argv[opt + 1], b, start ) ) return 2;
+
+    bool deviation = false;
+    printf( "%-12s %8s %8s %12s %12s %12s  %s\n", "signal", "edges a", "edges b",
+            "max shift", "mean shift", "max length", "first deviation" );
+    for ( auto &sa : a ) {
+        auto sbIt = b.find( sa.first );
+        if ( sbIt == b.end() ) {
+            printf( "%-12s only in %s\n", sa.first.c_str(), argv[opt] );
+            deviation = true;
+            continue;
+        }
+        const std::vector<edge_t> &ea = sa.second.edges, &eb = sbIt->second.edges;
+        size_t n = ea.size() < eb.size() ? ea.size() : eb.size();
+        double maxShift = 0, sumShift = 0, maxLen = 0;
+        double firstDev = -1;
+        for ( size_t i = 0; i < n; i++ ) {
+            double shift = fabs( eb[i].time - ea[i].time );
+            if ( ea[i].level != eb[i].level ) shift = INFINITY;
+            double len = 0;
+            if ( i > 0 ) len = fabs( ( eb[i].time - eb[i - 1].time ) - ( ea[i].time - ea[i - 1].time ) );
+            if ( shift > maxShift ) maxShift = shift;
+            if ( len > maxLen ) maxLen = len;
+            sumShift += shift;
+            if ( ( shift > tolerance || len > tolerance ) && firstDev < 0 ) firstDev = ea[i].time;
+        }
+        if ( ea.size() != eb.size() && firstDev < 0 ) firstDev = n < ea.size() ? ea[n].time : eb[n].time;
+        char devText[32] = "-";
+        if ( firstDev >= 0 ) {
+            snprintf( devText, sizeof(devText), "%.1fus", firstDev );
+            deviation = true;
+        }
+        printf( "%-12s %8zu %8zu %10.1fus %10.2fus %10.1fus  %s\n", sa.first.c_str(), ea.size(), eb.size(),
+                maxShift, n ? sumShift / n : 0.0, maxLen, devText );
+    }
+    for ( auto &sb : b ) {
+        if ( a.find( sb.first ) == a.end() ) {
+            printf( "%-12s only in %s\n", sb.first.c_str(), argv[opt + 1] );
+            deviation = true;
+        }
+    }
+    return deviation ? 1 : 0;
+}
@@ -189,18 +189,37 @@
 #define MINPULSEWIDTH   700U      // don't make it shorter than 700
 #define MAXPULSEWIDTH   2300U     // don't make it longer than 2300
 #endif
+#define MAX_SERVOS      16      // max number of servos ( ESP32: max 16, all others: max 63 )
+#define SERVO_OVERLAP   2       // max nbr of simultaneous servo pulses ( not ESP ). Every pulse allows up to
+                                // 8 servos within the 20ms cycle, e.g. set it to 4 for 32 servos
+#define SERVO_CYCLETIME 20000   // servo cycle in µs ( 3000...20000, not ESP32 ). Cycles shorter than 20ms
+                                // are only for digital servos! setSpeed() values are always related to 20ms
+#define SERVO_WAKE_MAX  0       // max nbr of servos that start creating pulses in the same cycle ( not ESP ).
+                                // Spreads the inrush current after autoOff or attach. 0 = no limit
+
+//#define MOTO_POS64            // stepper position is counted in 64 bit ( for long running endless rotation, see readSteps64() )
 
 // softled related defines
 #define LED_DEFAULT_RISETIME   50
+//#define SOFTLED_BAM           // AVR only: softleds with bit angle modulation. Every PWM cycle needs a fixed number of
+                                // IRQs with one port write per port, independent of the number of leds ( 64 pwm steps )
+//#define SOFTLED_DITHER        // AVR only: higher resolution of softled fading. The pulselength is computed in 1/16
+                                // cycles and dithered over several PWM cycles ( no additional IRQs )
+
+// diagnostic defines
+//#define MOTO_STATS            // collect timing statistics of the stepper/softled and servo IRQ ( see class MoToStats )
+//#define MOTO_TRACE    32      // size of ISR event trace buffer ( power of 2, max 128, see class MoToTrace )
 
 //  !!!!!!!!!!!!  Don't change anything after tis line !!!!!!!!!!!!!!!!!!!!
  
 
 #include <utilities/MoToBase.h>
+#include <utilities/MoToTrace.h>
 #include <utilities/MoToStepper.h>
 #include <utilities/MoToServo.h>
 #include <utilities/MoToSoftled.h>
 #include <utilities/MoToPwm.h>
+#include <utilities/MoToStats.h>
 #ifdef ARCHITECT_INCLUDE
 #include ARCHITECT_INCLUDE
 #endif
@@ -12,6 +12,10 @@ uint8_t noStepISR_Cnt;   // Counter for nested StepISr-disable
 //void ISR_Stepper(void);     // defined in MoToISR.cpp
 nextCycle_t nextCycle;
 static nextCycle_t cyclesLastIRQ = 1;  // cycles since last IRQ
+#ifdef MOTO_STATS
+static uint16_t shiftTics = 0;      // the IRQ has been shifted by an overrun of the previous IRQ
+const uint16_t LATEMARGIN = 10;     // normal IRQ latency ( tics )
+#endif
 // ---------- OCRxB Compare Interrupt used for stepper motor and Softleds ----------------
 void stepperISR(uint8_t cyclesLastIRQ) __attribute__ ((weak));
 void softledISR(uint8_t cyclesLastIRQ) __attribute__ ((weak));
@@ -20,6 +24,15 @@ ISR ( TIMERx_COMPB_vect) {
   // Timer1 Compare B, used for stepper motor, starts every CYCLETIME us
     // 26-09-15 An Interrupt is only created at timeslices, where data is to output
     SET_TP1;
+    TRACE_EVENT( TR_STEPIRQ, 0, cyclesLastIRQ );
+    #ifdef MOTO_STATS
+    // delay of this IRQ against its scheduled time, steps that are output in this IRQ are late by this time
+    tmp = GET_COUNT - OCRxB ;
+    if ( tmp > 1000 ) tmp += TIMER_OVL_TICS; // there was a timer overflow
+    tmp += shiftTics;
+    shiftTics = 0;
+    isrStats.lateTics = tmp > LATEMARGIN ? tmp : 0;
+    #endif
     nextCycle = ISR_IDLETIME  / CYCLETIME ;// min ist one cycle per IDLETIME
     if ( stepperISR ) stepperISR(cyclesLastIRQ);
     //============  End of steppermotor ======================================
@@ -35,10 +48,18 @@ ISR ( TIMERx_COMPB_vect) {
         // we assume a max. runtime of 1000 Tics ( = 500µs , what nevver should happen )
         tmp = GET_COUNT - OCRxB ;
         if ( tmp > 1000 ) tmp += TIMER_OVL_TICS; // there was a timer overflow
+        #ifdef MOTO_STATS
+        statsIsrTime( tmp );
+        #endif
         if ( tmp > (CYCLETICS-10) ) {
             // runtime was too long, next IRQ mus be started immediatly
             //SET_TP3;
             tmp = GET_COUNT+10; 
+            #ifdef MOTO_STATS
+            statsIsrOverrun();
+            shiftTics = tmp - ( OCRxB + CYCLETICS );    // delay against the regular schedule
+            if ( shiftTics > 1000 ) shiftTics += TIMER_OVL_TICS; // there was a timer overflow
+            #endif
         } else {
             tmp = OCRxB + CYCLETICS;
         }
@@ -46,6 +67,12 @@ ISR ( TIMERx_COMPB_vect) {
         //SET_TP1;
     } else {
         // time till next IRQ is more then one cycletime
+        #ifdef MOTO_STATS
+        tmp = GET_COUNT - OCRxB ;
+        if ( tmp > 1000 ) tmp += TIMER_OVL_TICS; // there was a timer overflow
+        statsIsrTime( tmp );
+        if ( tmp > nextCycle * CYCLETICS ) statsIsrOverrun();
+        #endif
         // compute next IRQ-Time in us, not in tics, so we don't need long
         tmp = ( OCRxB / TICS_PER_MICROSECOND + nextCycle * CYCLETIME );
         if ( tmp > TIMERPERIODE ) tmp = tmp - TIMERPERIODE;
@@ -53,6 +80,7 @@ ISR ( TIMERx_COMPB_vect) {
     }
     interrupts();
     cyclesLastIRQ = nextCycle;
+    TRACE_EVENT( TR_NEXTIRQ, 0, nextCycle );
     CLR_TP1; // Oszimessung Dauer der ISR-Routine
 }
 ////////////////////////////////////////////////////////////////////////////////////////////
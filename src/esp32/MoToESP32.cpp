@@ -19,9 +19,14 @@ void IRAM_ATTR ISR_Stepper(void) {
     nextCycle = ISR_IDLETIME  / CYCLETIME ;// min ist one cycle per IDLETIME
     portENTER_CRITICAL_ISR(&stepperMux);
     cyclesLastIRQ = (aktAlarm - lastAlarm) / TICS_PER_MICROSECOND;
+    TRACE_EVENT( TR_STEPIRQ, 0, cyclesLastIRQ );
     if ( stepperISR ) stepperISR(cyclesLastIRQ);
 	// next alarm ISR must be at least MIN_STEP_CYCLE/2 beyond last alarm value ( time between to ISR's )
     lastAlarm = aktAlarm;
+    #ifdef MOTO_STATS
+    uint64_t isrEnd = timerRead(stepTimer);
+    statsIsrTime( isrEnd - lastAlarm );
+    #endif
     aktAlarm = lastAlarm+(nextCycle*TICS_PER_MICROSECOND); // minimumtime until next Interrupt
     uint64_t minNextAlarm = lastAlarm + (MIN_STEP_CYCLE*TICS_PER_MICROSECOND/2);
 	if ( aktAlarm < minNextAlarm ) {
@@ -29,6 +34,10 @@ void IRAM_ATTR ISR_Stepper(void) {
         CLR_TP1;
 		aktAlarm =  minNextAlarm;
 	}
+    #ifdef MOTO_STATS
+    if ( aktAlarm <= isrEnd ) statsIsrOverrun();    // alarm time has already passed
+    #endif
+    TRACE_EVENT( TR_NEXTIRQ, 0, (aktAlarm - lastAlarm) / TICS_PER_MICROSECOND );
     //3.0.3 void timerAlarm(hw_timer_t * timer, uint64_t alarm_value, bool autoreload, uint64_t reload_count);
     timerAlarm(stepTimer, aktAlarm , false, 0); // no autorelaod, 0=unlimited - zs6buj
     //timerAlarmEnable(stepTimer);  // auto from esp32 core 3.0
@@ -11,6 +11,10 @@ uint8_t noStepISR_Cnt;   // Counter for nested StepISr-disable
 
 nextCycle_t nextCycle;
 static nextCycle_t cyclesLastIRQ = 1;  // cycles since last IRQ
+#ifdef MOTO_STATS
+static uint16_t shiftTics = 0;      // the IRQ has been shifted by an overrun of the previous IRQ
+const uint16_t LATEMARGIN = 2;      // normal IRQ latency ( tics, 4µs on 4809 )
+#endif
 // ---------- OCRxB Compare Interrupt used for stepper motor and Softleds ----------------
 void stepperISR(uint8_t cyclesLastIRQ) __attribute__ ((weak));
 void softledISR(uint8_t cyclesLastIRQ) __attribute__ ((weak));
@@ -26,6 +30,15 @@ ISR ( TCA0_CMP1_vect) {
     SET_TP1;
 	TCA0.SINGLE.INTFLAGS = TCA_SINGLE_CMP1_bm;	// Reset IRQ-flag
 
+    TRACE_EVENT( TR_STEPIRQ, 0, cyclesLastIRQ );
+    #ifdef MOTO_STATS
+    // delay of this IRQ against its scheduled time, steps that are output in this IRQ are late by this time
+    tmp = GET_COUNT - OCRxB ;
+    if ( tmp > 120 ) tmp += TIMER_OVL_TICS; // there was a timer overflow
+    tmp += shiftTics;
+    shiftTics = 0;
+    isrStats.lateTics = tmp > LATEMARGIN ? tmp : 0;
+    #endif
     nextCycle = ISR_IDLETIME  / CYCLETIME ;// min ist one cycle per IDLETIME
     if ( stepperISR ) stepperISR(cyclesLastIRQ);
     //============  End of steppermotor ======================================
@@ -44,10 +57,18 @@ ISR ( TCA0_CMP1_vect) {
 		// so if the difference is > 120 tics, we assume an timer overflow
         tmp = GET_COUNT - OCRxB ;
         if ( tmp > 120 ) tmp += TIMER_OVL_TICS; // there was a timer overflow
+        #ifdef MOTO_STATS
+        statsIsrTime( tmp );
+        #endif
         if ( tmp > (CYCLETICS-2) ) {
             // runtime was too long, next IRQ mus be started immediatly
             //SET_TP3;
             tmp = GET_COUNT+2; 
+            #ifdef MOTO_STATS
+            statsIsrOverrun();
+            shiftTics = tmp - ( OCRxB + CYCLETICS );    // delay against the regular schedule
+            if ( shiftTics > 120 ) shiftTics += TIMER_OVL_TICS; // there was a timer overflow
+            #endif
         } else {
             tmp = OCRxB + CYCLETICS;
         }
@@ -56,12 +77,19 @@ ISR ( TCA0_CMP1_vect) {
         SET_TP1;
     } else {
         // time till next IRQ is more then one cycletime
+        #ifdef MOTO_STATS
+        tmp = GET_COUNT - OCRxB ;
+        if ( tmp > 120 ) tmp += TIMER_OVL_TICS; // there was a timer overflow
+        statsIsrTime( tmp );
+        if ( tmp > nextCycle * CYCLETICS ) statsIsrOverrun();
+        #endif
         tmp = ( OCRxB + (nextCycle * CYCLETICS) );
         if ( tmp >= TIMER_OVL_TICS ) tmp = tmp - TIMER_OVL_TICS;
         OCRxB = tmp ;
     }
 	interrupts();
     cyclesLastIRQ = nextCycle;
+    TRACE_EVENT( TR_NEXTIRQ, 0, nextCycle );
     CLR_TP1; // Oszimessung Dauer der ISR-Routine
 }
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -4,16 +4,6 @@
 #define debugTP
 //#define debugPrint
 #include <utilities/MoToDbg.h>
-#ifdef debugIRQ
-#warning debugIRQ aktiv
-	uint8_t dbgIx;	// index of irq values
-	irqValues_h dbgTimer[dbgIxMax];
-#endif
-#ifdef debugSvIRQ
-	#warning debug Servo IRQ active
-	uint8_t dbSvIx;
-	irqSvVal_t irqSvVal[dbSvIxMax];
-#endif
 
 //#warning "HW specfic - RA4M1 ---"
 // RA4M1 specific variables
@@ -40,18 +30,10 @@ void ISR_Stepper() {
     // GPT Timer CCMPA, used for stepper motor and softleds, starts every nextCycle us
 	// Quit irq-flag
 	icuRegP->IELSR_b[IRQnStepper].IR = 0;
-#ifdef debugIRQ
-	if( dbgIx < dbgIxMax ) {
-		dbgTimer[dbgIx].timestamp = micros();
-		dbgTimer[dbgIx].preTimerCnt = gptRegP->GTCNT;
-		dbgTimer[dbgIx].preTimerCmp = gptRegP->GTCCR[0];
-		dbgTimer[dbgIx].cyclesLastIRQ = cyclesLastIRQ;
-	}
-#endif
- 
 
  // nextCycle ist set in stepperISR and softledISR
     SET_TP1;
+    TRACE_EVENT( TR_STEPIRQ, 0, cyclesLastIRQ );
     nextCycle = ISR_IDLETIME  / CYCLETIME ;// min ist one cycle per IDLETIME
     if ( stepperISR ) stepperISR(cyclesLastIRQ);
     //============  End of steppermotor ======================================
@@ -62,10 +44,16 @@ void ISR_Stepper() {
 	uint32_t minOCR = gptRegP->GTCNT;
 	uint32_t nextOCR = gptRegP->GTCCR[0];  // CCRA = Step cmp
 	if ( minOCR < nextOCR ) minOCR += TIMER_OVL_TICS; // timer had overflow already
+    #ifdef MOTO_STATS
+    statsIsrTime( minOCR - nextOCR );
+    #endif
     minOCR = minOCR + ( (MIN_STEP_CYCLE/4) * TICS_PER_MICROSECOND ); // minimumvalue for next OCR
 	nextOCR = nextOCR + ( nextCycle * TICS_PER_MICROSECOND );
 	if ( nextOCR < minOCR ) {
 		// time till next ISR ist too short, set to mintime and adjust nextCycle
+        #ifdef MOTO_STATS
+        statsIsrOverrun();
+        #endif
         SET_TP2;
 		nextOCR = minOCR;
 		nextCycle = ( nextOCR - gptRegP->GTCCR[0]  ) / TICS_PER_MICROSECOND;
@@ -74,14 +62,7 @@ void ISR_Stepper() {
     if ( nextOCR > (uint16_t)TIMER_OVL_TICS ) nextOCR -= TIMER_OVL_TICS;
     gptRegP->GTCCR[0] = nextOCR  ;
     cyclesLastIRQ = nextCycle;
-#ifdef debugIRQ
-	if( dbgIx < dbgIxMax ) {
-		dbgTimer[dbgIx].postTimerCnt = gptRegP->GTCNT;
-		dbgTimer[dbgIx].postTimerCmp = gptRegP->GTCCR[0];
-		dbgTimer[dbgIx].nextCycle = nextCycle;
-		dbgIx++;
-	}
-#endif
+    TRACE_EVENT( TR_NEXTIRQ, 0, nextCycle );
     CLR_TP1; // Oszimessung Dauer der ISR-Routine
 }
  ////////////////////////////////////////////////////////////////////////////////////////////
@@ -16,6 +16,7 @@ void ISR_Stepper() {
     // Timer4 Channel 1, used for stepper motor and softleds, starts every nextCycle us
     // nextCycle ist set in stepperISR and softledISR
     SET_TP1;
+    TRACE_EVENT( TR_STEPIRQ, 0, cyclesLastIRQ );
     nextCycle = ISR_IDLETIME  / CYCLETIME ;// min ist one cycle per IDLETIME
     if ( stepperISR ) stepperISR(cyclesLastIRQ);
     //============  End of steppermotor ======================================
@@ -26,10 +27,16 @@ void ISR_Stepper() {
 	int minOCR = timer_get_count(MT_TIMER);
 	int nextOCR = timer_get_compare(MT_TIMER, STEP_CHN);
 	if ( minOCR < nextOCR ) minOCR += TIMER_OVL_TICS; // timer had overflow already
+    #ifdef MOTO_STATS
+    statsIsrTime( minOCR - nextOCR );
+    #endif
     minOCR = minOCR + ( (MIN_STEP_CYCLE/4) * TICS_PER_MICROSECOND ); // minimumvalue for next OCR
 	nextOCR = nextOCR + ( nextCycle * TICS_PER_MICROSECOND );
 	if ( nextOCR < minOCR ) {
 		// time till next ISR ist too short, set to mintime and adjust nextCycle
+        #ifdef MOTO_STATS
+        statsIsrOverrun();
+        #endif
         SET_TP2;
 		nextOCR = minOCR;
 		nextCycle = ( nextOCR - timer_get_compare(MT_TIMER, STEP_CHN)  ) / TICS_PER_MICROSECOND;
@@ -38,6 +45,7 @@ void ISR_Stepper() {
     if ( nextOCR > (uint16_t)TIMER_OVL_TICS ) nextOCR -= TIMER_OVL_TICS;
     timer_set_compare( MT_TIMER, STEP_CHN, nextOCR ) ;
     cyclesLastIRQ = nextCycle;
+    TRACE_EVENT( TR_NEXTIRQ, 0, nextCycle );
     CLR_TP1; // Oszimessung Dauer der ISR-Routine
 }
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -60,7 +60,24 @@
 #endif
 extern nextCycle_t nextCycle;   // to be used in ISR for stepper and softled
 
-#define ISR_IDLETIME    5000        // max time between two Stepper/Softled ISRs ( sec )
+#define ISR_IDLETIME    ( TIMERPERIODE < 5000 ? TIMERPERIODE : 5000 ) // max time between two Stepper/Softled ISRs ( sec )
+
+#ifdef MOTO_STATS
+// timing statistics of the stepper/softled ISR ( read by class MoToStats )
+typedef struct {
+    uint16_t isrOverruns;       // nbr of ISRs that lasted longer than the time until the next ISR
+    uint16_t maxIsrTics;        // max time from compare match to the end of the ISR ( timer tics )
+    uint16_t lateTics;          // delay of the running ISR against its schedule ( timer tics, 0 = in time, 8-bit only )
+} isrStats_t;
+extern isrStats_t isrStats;
+
+static inline __attribute__((__always_inline__)) void statsIsrTime( uint32_t tics ) {
+    if ( tics > isrStats.maxIsrTics ) isrStats.maxIsrTics = tics > 0xffff ? 0xffff : tics;
+}
+static inline __attribute__((__always_inline__)) void statsIsrOverrun() {
+    if ( isrStats.isrOverruns < 0xffff ) isrStats.isrOverruns++;
+}
+#endif
 
 // old Class names ( for compatibility with former sketches )
 #define Stepper4    MoToStepper
@@ -79,7 +96,7 @@ extern nextCycle_t nextCycle;   // to be used in ISR for stepper and softled
 
 // internal defines
 
-#define TIMERPERIODE    20000   // Timer Overflow in s
+#define TIMERPERIODE    SERVO_CYCLETIME   // Timer Overflow in s ( = servo cycle )
 //#define TIMER_OVL_TICS  ( TIMERPERIODE*TICS_PER_MICROSECOND )
 constexpr uint16_t TIMER_OVL_TICS = ( TIMERPERIODE*TICS_PER_MICROSECOND );
 
@@ -15,6 +15,90 @@
 // Global Data for all instances and classes  --------------------------------
 // Variables for servos
 static byte servoCount = 0;
+const byte NO_PIN = 0xff;
+const int8_t NOT_ATTACHED = -1;
+static volatile uint8_t servoCycle = 0;    // counts servo cycles ( for start of group movements, not ESP )
+
+// easing of servo movements ( used in ISR ) -------------------------------------
+// The curves are computed with phase and result as fixed point values 0...0xffff ( = 0...1.0 )
+// with only a few multiplications, no division. No 'switch' to avoid jump tables in flash on ESP.
+static inline __attribute__((__always_inline__)) uint16_t easeCurve( uint8_t type, uint16_t p ) {
+    uint32_t p2, p3;
+    if ( type == EASE_IN ) {
+        return ( (uint32_t)p * p ) >> 16;
+    } else if ( type == EASE_OUT ) {
+        p = ~p;
+        return ~(uint16_t)( ( (uint32_t)p * p ) >> 16 );
+    } else if ( type == EASE_INOUT ) {
+        // smoothstep: p² * ( 3 - 2p )
+        p2 = ( (uint32_t)p * p ) >> 16;
+        p3 = ( p2 * ( ( 3 * 0x10000L - 2 * (uint32_t)p ) >> 2 ) ) >> 14;
+        return p3 > 0xffff ? 0xffff : p3;
+    } else if ( type == EASE_CUBIC ) {
+        // 4p³ in the first half, mirrored in the second half
+        bool second = p & 0x8000;
+        if ( second ) p = ~p;
+        p2 = ( (uint32_t)p * p ) >> 16;
+        p3 = ( ( p2 * p ) >> 16 ) << 2;
+        if ( p3 > 0xffff ) p3 = 0xffff;
+        return second ? ~(uint16_t)p3 : p3;
+    } else if ( type == EASE_BOUNCE ) {
+        // 4 parabolas with 7.5625 ( = 121/16 ) * p² + offset ( 'bounce out' )
+        uint16_t offset;
+        if ( p < 23831 ) {              // 1/2.75
+            offset = 0;
+        } else if ( p < 47663 ) {       // 2/2.75
+            p -= 35747; offset = 49152;     // 1.5/2.75, 0.75
+        } else if ( p < 59578 ) {       // 2.5/2.75
+            p -= 53620; offset = 61440;     // 2.25/2.75, 0.9375
+        } else {
+            p -= 62556; offset = 64512;     // 2.625/2.75, 0.984375
+        }
+        // p is now in the range -0.182 ... 0.364
+        int16_t sp = p;
+        p2 = ( ( ( (int32_t)sp * sp ) >> 16 ) * 121 ) >> 4;
+        p2 += offset;
+        return p2 > 0xffff ? 0xffff : p2;
+    }
+    return p;   // EASE_LINEAR
+}
+
+static inline __attribute__((__always_inline__)) int linInc( servoData_t *servoDataP ) {
+    // increment of a linear movement in this cycle. With cycles shorter than 20ms the increment per
+    // cycle has a fraction, the sum of the fractions is added when it overflows
+    #if SV_CYCLETIME != 20000
+    uint16_t acc = servoDataP->incAcc + servoDataP->incFrac;
+    bool carry = acc < servoDataP->incAcc;
+    servoDataP->incAcc = acc;
+    return servoDataP->inc + carry;
+    #else
+    return servoDataP->inc;
+    #endif
+}
+
+#if SV_CYCLETIME != 20000
+static inline uint32_t incFix( const servoData_t &servoData ) {
+    // increment of a linear movement per cycle as 16.16 fixpoint value
+    return ( (uint32_t)servoData.inc << 16 ) + servoData.incFrac;
+}
+#endif
+
+static inline __attribute__((__always_inline__)) void easeStep( servoData_t *servoDataP ) {
+    // next position of a movement with easing ( the starting point must be valid )
+    #ifndef IS_ESP
+    if ( (int8_t)( servoCycle - servoDataP->easeStart ) < 0 ) return;   // group movement not yet started
+    #endif
+    uint16_t phase = servoDataP->easePhase + servoDataP->easeInc;
+    if ( phase < servoDataP->easePhase || phase == 0xffff ) {
+        // end of movement
+        servoDataP->easePhase = 0xffff;
+        servoDataP->ist = servoDataP->soll;
+    } else {
+        servoDataP->easePhase = phase;
+        int32_t delta = servoDataP->soll - servoDataP->easeFrom;
+        servoDataP->ist = servoDataP->easeFrom + ( ( delta * ( easeCurve( servoDataP->moveEasing, phase ) >> 1 ) ) >> 15 );
+    }
+}
 
 
 #ifdef IS_ESP //------------------- Servo Interrupt für ESP8266 und ESP32 ----------------------
@@ -29,14 +113,23 @@ void IRAM_ATTR ISR_Servo( void *arg ) {
 	if ( digitalRead( _servoData->pin) == HIGH ) return ;
     portENTER_CRITICAL_ISR(&servoMux);
     SET_TP2;
-    if ( _servoData->ist != _servoData->soll ) {
+    if ( _servoData->detachReq != SV_DETACH_NONE ) {
+        // servo is detached: stop pulses at the end of this pulse. Releasing the pin is done
+        // outside the IRQ
+        if ( _servoData->detachReq == SV_DETACH_REQ ) {
+            servoPulseOff( _servoData );
+            _servoData->detachReq = SV_DETACH_OFF;
+        }
+    } else if ( _servoData->ist != _servoData->soll ) {
         //SET_TP1;
-        _servoData->offcnt = 50;
-        if ( _servoData->ist > _servoData->soll ) {
-            _servoData->ist -= _servoData->inc;
+        _servoData->offcnt = OFF_COUNT;
+        if ( _servoData->easeInc != 0 ) {
+            easeStep( _servoData );
+        } else if ( _servoData->ist > _servoData->soll ) {
+            _servoData->ist -= linInc( _servoData );
             if ( _servoData->ist < _servoData->soll ) _servoData->ist = _servoData->soll;
         } else {
-            _servoData->ist += _servoData->inc;
+            _servoData->ist += linInc( _servoData );
             if ( _servoData->ist > _servoData->soll ) _servoData->ist = _servoData->soll;
         }
         //CLR_TP1;
@@ -58,24 +151,78 @@ void IRAM_ATTR ISR_Servo( void *arg ) {
 
 #ifndef IS_ESP //---------------------- Timer-interrupt for non ESP -----------------------------
 static servoData_t* lastServoDataP = NULL; //start of ServoData-chain
-static servoData_t* pulseP = NULL;         // pulse Ptr in IRQ
-static servoData_t* activePulseP = NULL;   // Ptr to pulse to stop
-static servoData_t* stopPulseP = NULL;     // Ptr to Pulse whose stop time is already in OCR1
-static servoData_t* nextPulseP = NULL;
-static enum { PON, POFF } IrqType = PON; // Cycle starts with 'pulse on'
-static uint16_t activePulseOff = 0;     // OCR-value of pulse end 
+static servoData_t* pulseP = NULL;         // pulse Ptr in IRQ ( next servo in chain to check )
+static servoData_t* nextPulseP = NULL;     // pulse to be started next ( NULL: not yet known )
 static uint16_t nextPulseLength = 0;
+static bool nextPulseDetached = false;  // servo of nextPulseP has been detached and attached again
+// pulses in flight, sorted by their end time. The end times are at least OFFMARGINTICS apart
+static servoData_t* activePulseP[SERVO_OVERLAP];
+static uint16_t activePulseOff[SERVO_OVERLAP];  // OCR-value of pulse end
+static uint8_t activeCnt = 0;           // number of running pulses
+static enum { PON, POFF, CSTART } IrqType = CSTART; // Cycle starts with 'cycle start'
+static MoToServoSequence *lastSeqP = NULL;  // start of sequence-chain
+static servoPower_t *lastPowerP = NULL;     // start of power rail chain
+#if SERVO_WAKE_MAX > 0
+static uint8_t wakeCnt = 0;             // nbr of servos, that started pulses in this pass of the servo chain
+#endif
 static bool speedV08 = true;    // Compatibility-Flag for speed method
 // create overlapping servo pulses
-// Positions of servopulses within 20ms cycle are variable, max 2 pulses at the same time
+// Positions of servopulses within 20ms cycle are variable, max SERVO_OVERLAP pulses at the same time
 // 27.9.15 with variable overlap, depending on length of next pulse: 16 Servos
 // 2.1.16 Enable interrupts after timecritical path (e.g. starting/stopping servo pulses)
 //        so other timecritical tasks can interrupt (nested interrupts)
 // 6.6.19 Because stepper IRQ now can last very long, it is disabled during servo IRQ
+// Every pulse end gets its own IRQ. A new pulse is started as soon as its end does not come
+// closer than OFFMARGINTICS to the end of a running pulse. If its start time is too close to
+// a pulse end, it is checked again in the IRQ of that pulse end.
+static inline bool pulseAllowed( servoData_t *servoDataP ) {
+    // check the power rail and the nbr of servos waking up. If false is returned, the servo 
+    // must not create a pulse in this cycle and doesn't move
+    if ( !servoDataP->on || ( servoDataP->ist == servoDataP->soll && servoDataP->offcnt <= 1
+                              && !servoDataP->noAutoff ) ) {
+        // no pulse is created ( autoOff )
+        servoDataP->pulsing = false;
+        return true;
+    }
+    if ( servoDataP->powerP != NULL ) {
+        servoDataP->powerP->needed = true;
+        if ( !servoDataP->powerP->on ) return false;    // wait until the power is switched on
+    }
+    #if SERVO_WAKE_MAX > 0
+    if ( !servoDataP->pulsing ) {
+        if ( wakeCnt >= SERVO_WAKE_MAX ) return false;  // wait for the next pass of the servo chain
+        wakeCnt++;
+    }
+    #endif
+    servoDataP->pulsing = true;
+    return true;
+}
+
+static inline void servoPowerSwitch() {
+    // switch the power rails at the end of a pass of the servo chain. No pulse is active
+    for ( servoPower_t *powerP = lastPowerP; powerP != NULL; powerP = powerP->prevPowerP ) {
+        if ( powerP->needed != powerP->on ) {
+            powerP->on = powerP->needed;
+            digitalWrite( powerP->pin, powerP->on ? powerP->onLevel : !powerP->onLevel );
+        }
+        powerP->needed = false;
+    }
+    #if SERVO_WAKE_MAX > 0
+    wakeCnt = 0;
+    #endif
+}
+
 static bool searchNextPulse() {
     //SET_TP4;
-    while ( pulseP != NULL && pulseP->soll < 0 ) {
+    while ( pulseP != NULL && ( pulseP->soll < 0 || !pulseAllowed( pulseP ) ) ) {
         //SET_TP4;
+        if ( pulseP->detachReq == SV_DETACH_REQ ) {
+            // complete detach. The last pulse of this servo ended in the previous cycle
+            pinMode( pulseP->pin, INPUT );
+            pulseP->pin = NO_PIN;
+            pulseP->pwmNbr = NOT_ATTACHED;
+            pulseP->detachReq = SV_DETACH_NONE;
+        }
         pulseP = pulseP->prevServoDataP;
         //CLR_TP4;
     }
@@ -89,14 +236,17 @@ static bool searchNextPulse() {
         if ( pulseP->ist == pulseP->soll ) {
             // no change of pulselength
             if ( pulseP->offcnt > 0 ) pulseP->offcnt--;
+        } else if ( pulseP->easeInc != 0 && pulseP->ist >= 0 ) {
+            pulseP->offcnt = OFF_COUNT;
+            easeStep( pulseP );
         } else if ( pulseP->ist < pulseP->soll ) {
             pulseP->offcnt = OFF_COUNT;
             if ( pulseP->ist < 0 ) pulseP->ist = pulseP->soll; // first position after attach
-            else pulseP->ist += pulseP->inc;
+            else pulseP->ist += linInc( pulseP );
             if ( pulseP->ist > pulseP->soll ) pulseP->ist = pulseP->soll;
         } else {
             pulseP->offcnt = OFF_COUNT;
-            pulseP->ist -= pulseP->inc;
+            pulseP->ist -= linInc( pulseP );
             if ( pulseP->ist < pulseP->soll ) pulseP->ist = pulseP->soll;
         } 
         //CLR_TP4;
@@ -104,6 +254,76 @@ static bool searchNextPulse() {
     } 
 } //end of 'searchNextPulse'
 
+static inline void fetchNextPulse() {
+    // look for the pulse to be started next
+    nextPulseDetached = false;
+    if ( searchNextPulse() ) {
+        nextPulseP = pulseP;
+        nextPulseLength = pulseP->ist/INC_PER_TIC;
+        pulseP = pulseP->prevServoDataP;
+    } else {
+        nextPulseP = NULL;
+    }
+}
+
+static inline void startNextPulse() {
+    // start the 'nextPulse' now, it becomes an active pulse
+    uint16_t tmpTCNT1= GET_COUNT-4; // compensate for computing time
+    if ( nextPulseP->on && (nextPulseP->offcnt+nextPulseP->noAutoff) > 0 && !nextPulseDetached ) {
+        // its a 'real' pulse, set output pin
+        #ifdef FAST_PORTWRT
+        *nextPulseP->portAdr |= nextPulseP->bitMask;
+        #else
+        digitalWrite( nextPulseP->pin, HIGH );
+        #endif
+    }
+    #ifdef MOTO_STATS
+    // time of the rising edge: read it before the sorting below, which lasts longer with more pulses
+    nextPulseP->pulseOn = GET_COUNT;
+    nextPulseP->pulseLen = nextPulseLength;
+    #endif
+    // insert into list of running pulses ( sorted by end time )
+    uint16_t pulseOff = nextPulseLength + tmpTCNT1; // end of actually started pulse
+    uint8_t ix = activeCnt++;
+    for ( ; ix > 0 && activePulseOff[ix-1] > pulseOff; ix-- ) {
+        activePulseP[ix] = activePulseP[ix-1];
+        activePulseOff[ix] = activePulseOff[ix-1];
+    }
+    activePulseP[ix] = nextPulseP;
+    activePulseOff[ix] = pulseOff;
+    TRACE_EVENT( TR_SERVO, nextPulseP->servoIx, nextPulseLength );
+}
+
+void servoSeqTick() {
+    // start keyframes of all running sequences. Called at the start of a servo cycle
+    for ( MoToServoSequence *seqP = lastSeqP; seqP != NULL; seqP = seqP->_prevSeqP ) {
+        if ( seqP->_running ) seqP->_tick();
+    }
+}
+
+#ifdef MOTO_STATS
+static inline void statsPulseLen( servoData_t *servoDataP ) {
+    // compare the real length of the pulse, that has just been switched off, with the computed length
+    int16_t err = (uint16_t)( (uint16_t)GET_COUNT - servoDataP->pulseOn ) - servoDataP->pulseLen;
+    if ( err < servoDataP->minPulseErr ) servoDataP->minPulseErr = err;
+    if ( err > servoDataP->maxPulseErr ) servoDataP->maxPulseErr = err;
+    if ( ( err > (int16_t)TICS_PER_MICROSECOND || err < -(int16_t)TICS_PER_MICROSECOND )
+         && servoDataP->badPulses < 0xffff ) servoDataP->badPulses++;
+}
+#endif
+
+static inline long freePulseOff( long pulseOff ) {
+    // returns the first pulse end time at or after pulseOff, that is not closer than OFFMARGINTICS 
+    // to the end of a running pulse
+    for ( uint8_t ix = 0; ix < activeCnt; ix++ ) {
+        if ( pulseOff < (long)activePulseOff[ix] + (long)OFFMARGINTICS 
+          && pulseOff + (long)OFFMARGINTICS > (long)activePulseOff[ix] ) {
+            pulseOff = (long)activePulseOff[ix] + (long)OFFMARGINTICS;
+        }
+    }
+    return pulseOff;
+}
+
 // ---------- OCRxA Compare Interrupt used for servo motor (overlapping pulses) ----------------
 // not for ESP processors
 #if defined ( ARDUINO_ARCH_AVR ) 
@@ -120,130 +340,80 @@ void ISR_Servo( void) {
     // Timer1 Compare A, used for servo motor
     if ( IrqType == POFF ) { // Pulse OFF time
         //SET_TP2; // Oszimessung Dauer der ISR-Routine OFF
-        //SET_TP3; // Oszimessung Dauer der ISR-Routine
-        IrqType = PON ; // it's (nearly) always alternating
-        // switch off previous started pulse
+        // switch off the pulse that ends first
         #ifdef FAST_PORTWRT
-        *stopPulseP->portAdr &= ~stopPulseP->bitMask;
+        *activePulseP[0]->portAdr &= ~activePulseP[0]->bitMask;
         #else
-        digitalWrite( stopPulseP->pin, LOW );
+        digitalWrite( activePulseP[0]->pin, LOW );
         #endif
-        if ( nextPulseLength > 0 ) {
-            // there is a next pulse to start, compute starttime 
-            // set OCR value to next starttime ( = endtime of running pulse -overlap )
-            // next starttime must behind actual timervalue and endtime of next pulse must
-            // lay after endtime of runningpuls + safetymargin (it may be necessary to start
-            // another pulse between these 2 ends)
-            long tmpTCNT1 = GET_COUNT + MARGINTICS/2;
-            //CLR_TP3 ;
-            OCRxA = max ( (long)((long)activePulseOff + (long) MARGINTICS - (long) nextPulseLength), tmpTCNT1 );
-        } else {
-            // we are at the end, no need to start another pulse in this cycle
-            if ( activePulseOff ) {
-                // there is still a running pulse to stop
-                //SET_TP1; // Oszimessung Dauer der ISR-Routine
-                OCRxA = activePulseOff;
-                IrqType = POFF;
-                stopPulseP = activePulseP;
-                activePulseOff = 0;
-                //CLR_TP1; // Oszimessung Dauer der ISR-Routine
-            } else { // was last pulse, start over
-                pulseP = lastServoDataP;
-                nextPulseLength = 0;
-                OCRxA = FIRST_PULSE;
-            }
+        if ( activePulseP[0]->releasePin != NO_PIN ) {
+            // the servo has been attached to another pin during this pulse, release the old pin
+            digitalWrite( activePulseP[0]->releasePin, LOW );
+            pinMode( activePulseP[0]->releasePin, INPUT );
+            activePulseP[0]->releasePin = NO_PIN;
+        }
+        #ifdef MOTO_STATS
+        statsPulseLen( activePulseP[0] );
+        #endif
+        activeCnt--;
+        for ( uint8_t ix = 0; ix < activeCnt; ix++ ) {
+            activePulseP[ix] = activePulseP[ix+1];
+            activePulseOff[ix] = activePulseOff[ix+1];
         }
         //CLR_TP2; // Oszimessung Dauer der ISR-Routine OFF
-    } else { // Pulse ON - time
+    } else if ( IrqType == PON ) { // Pulse ON - time
         //SET_TP2; // Oszimessung Dauer der ISR-Routine ON
-        //if ( pulseP == lastServoDataP ) SET_TP3;
-        // look for next pulse to start
-        // do we know the next pulse already?
-        if ( nextPulseLength > 0 ) {
-            // yes we know, start this pulse and then look for next one
-            uint16_t tmpTCNT1= GET_COUNT-4; // compensate for computing time
-            if ( nextPulseP->on && (nextPulseP->offcnt+nextPulseP->noAutoff) > 0 ) {
-                // its a 'real' pulse, set output pin
-                //CLR_TP1;
-                #ifdef FAST_PORTWRT
-                *nextPulseP->portAdr |= nextPulseP->bitMask;
-                #else
-                digitalWrite( nextPulseP->pin, HIGH );
-                #endif
-            }
-            //SET_TP3;
-            // the 'nextPulse' we have started now, is from now on the 'activePulse', the running activPulse is now the
-            // pulse to stop next.
-            stopPulseP = activePulseP; // because there was a 'nextPulse' there is also an 'activPulse' which is the next to stop
-            OCRxA = activePulseOff;
-            activePulseP = nextPulseP;
-            activePulseOff = activePulseP->ist/INC_PER_TIC + tmpTCNT1; // end of actually started pulse
-            nextPulseLength = 0;
-            //SET_TP1;
-        }
-        if ( searchNextPulse() ) {
-            // found a pulse
-            if ( activePulseOff == 0 ) {
-                // it is the first pulse in the sequence, start it
-                //TOG_TP2;
-                SET_TP3;
-                activePulseP = pulseP; 
-                activePulseOff = pulseP->ist/INC_PER_TIC + GET_COUNT - 4; // compensate for computing time
-                if ( pulseP->on && (pulseP->offcnt+pulseP->noAutoff) > 0 ) {
-                    // its a 'real' pulse, set output pin
-                    #ifdef FAST_PORTWRT
-                    *pulseP->portAdr |= pulseP->bitMask;
-                    #else
-                    digitalWrite( pulseP->pin, HIGH );
-                    #endif
-                }
-                int32_t tmpTCNT1 = GET_COUNT+ MARGINTICS/2;
-                //SET_TP3;
-                // look for second pulse
-                //SET_TP4;
-                pulseP = pulseP->prevServoDataP;
-                //CLR_TP4;
-                if ( searchNextPulse() ) {
-                    // there is a second pulse - this is the 'nextPulse'
-                    nextPulseLength = pulseP->ist/INC_PER_TIC;
-                    nextPulseP = pulseP;
-                    //SET_TP4;
-                    pulseP = pulseP->prevServoDataP;
-                    //CLR_TP4;
-                    // set Starttime for 2. pulse in sequence
-                    OCRxA = max ( (long)((long)activePulseOff + (long) MARGINTICS - (long) nextPulseLength), tmpTCNT1  );
-                } else {
-                    // no next pulse, there is only one pulse
-                    OCRxA = activePulseOff;
-                    activePulseOff = 0;
-                    stopPulseP = activePulseP;
-                    IrqType = POFF;
-                }
-                CLR_TP3;
+        // we know the next pulse already, start this pulse and then look for next one
+        startNextPulse();
+        fetchNextPulse();
+    } else {
+        // start of cycle, no pulse is running. Look for the first pulse ( if there is
+        // no pulse left over from the last cycle ). It is started below
+        servoCycle++;
+        if ( lastSeqP != NULL ) servoSeqTick();
+        if ( nextPulseP == NULL ) fetchNextPulse();
+    }
+    
+    // start all pulses that can be started now, and compute time of next IRQ
+    while ( true ) {
+        if ( nextPulseP != NULL && activeCnt < SERVO_OVERLAP ) {
+            // there is a next pulse and a free slot. Can it be started now?
+            long tmpTCNT1 = GET_COUNT;
+            long nextPulseOff = freePulseOff( tmpTCNT1 + nextPulseLength );
+            if ( nextPulseOff > (long)TIMER_OVL_TICS - (long)MARGINTICS ) {
+                // pulse doesn't fit in this cycle anymore, it is the first pulse of the next cycle
+            } else if ( nextPulseOff == tmpTCNT1 + nextPulseLength ) {
+                startNextPulse();
+                fetchNextPulse();
+                continue;
             } else {
-                // its a pulse in sequence, so this is the 'nextPulse'
-                nextPulseLength = pulseP->ist/INC_PER_TIC;
-                nextPulseP = pulseP;
-                //SET_TP4;
-                pulseP = pulseP->prevServoDataP;
-                //CLR_TP4;
-                IrqType = POFF;
+                // no, compute starttime for an own IRQ. It must not be too close to a pulse end
+                nextPulseOff = freePulseOff( tmpTCNT1 + (long)OFFMARGINTICS + nextPulseLength );
+                long nextPulseOn = nextPulseOff - nextPulseLength;
+                if ( nextPulseOff <= (long)TIMER_OVL_TICS - (long)MARGINTICS
+                  && nextPulseOn + (long)OFFMARGINTICS <= (long)activePulseOff[0] ) {
+                    OCRxA = nextPulseOn;
+                    IrqType = PON;
+                    break;
+                }
             }
-        } else {
-            // found no pulse, so the last one is running or no pulse at all
-            
-            if ( activePulseOff == 0 ) {
-                // there wasn't any pulse, restart
+        }
+        if ( activeCnt > 0 ) {
+            // the next IRQ is the end of the first running pulse. The next pulse start ( if any )
+            // is checked again in that IRQ
+            OCRxA = activePulseOff[0];
+            IrqType = POFF;
+        } else { 
+            // was last pulse, start over ( with a pulse that didn't fit in this cycle, if any )
+            if ( nextPulseP == NULL ) {
                 pulseP = lastServoDataP;
-                nextPulseLength = 0;
-                OCRxA = FIRST_PULSE;
-            } else {
-                // is last pulse, don't start a new one
-                IrqType = POFF;
+                if ( lastPowerP != NULL || SERVO_WAKE_MAX > 0 ) servoPowerSwitch();
             }
+            OCRxA = FIRST_PULSE;
+            IrqType = CSTART;
         }
-        //CLR_TP2; CLR_TP3; // Oszimessung Dauer der ISR-Routine ON
-    } //end of 'pulse ON'
+        break;
+    }
 	setServoCmpAS(OCRxA);	// set Servo-compare register
     //CLR_TP1; CLR_TP3; // Oszimessung Dauer der ISR-Routine
     CLR_TP2;
@@ -256,16 +426,29 @@ void ISR_Servo( void) {
 // Class-specific Variables
 
 const byte NO_ANGLE = 0xff;
-const byte NO_PIN = 0xff;
-const int8_t NOT_ATTACHED = -1;
 
 MoToServo::MoToServo() //: _servoData.pin(NO_PIN),_angle(NO_ANGLE),_min16(1000/16),_max16(2000/16)
 {   _servoData.servoIx = servoCount++;
     _servoData.soll = -1;    // = not initialized
+    _servoData.easing = EASE_LINEAR;
+    _servoData.moveEasing = EASE_LINEAR;
+    _servoData.easeInc = 0;
     _servoData.pin = NO_PIN;
     _servoData.pwmNbr = NOT_ATTACHED;
+    _servoData.detachReq = SV_DETACH_NONE;
+    #ifndef IS_ESP
+    _servoData.powerP = NULL;
+    _servoData.pulsing = false;
+    _servoData.releasePin = NO_PIN;
+    #endif
+    #if defined MOTO_STATS && !defined IS_ESP
+    _servoData.minPulseErr = INT16_MAX;
+    _servoData.maxPulseErr = INT16_MIN;
+    _servoData.badPulses = 0;
+    #endif
     _minPw = MINPULSEWIDTH ;
     _maxPw = MAXPULSEWIDTH ;
+    _setSlope();
     #ifndef IS_ESP // there is no servochain on ESP
     noInterrupts(); // Add to servo-chain
     _servoData.prevServoDataP = lastServoDataP;
@@ -280,10 +463,18 @@ MoToServo::MoToServo() //: _servoData.pin(NO_PIN),_angle(NO_ANGLE),_min16(1000/1
 
 void MoToServo::setMinimumPulse(uint16_t t)
 {   _minPw = constrain( t, MINPULSEWIDTH,MAXPULSEWIDTH);
+    _setSlope();
 }
 
 void MoToServo::setMaximumPulse(uint16_t t)
 {   _maxPw = constrain( t, MINPULSEWIDTH,MAXPULSEWIDTH);
+    _setSlope();
+}
+
+void MoToServo::_setSlope() {
+    // the division is done only here, so write() needs only a multiplication
+    _minPos = time2tic( _minPw );
+    _posSlope = ( ( (long)time2tic( _maxPw ) - _minPos ) * 65536L ) / 180;
 }
 
 
@@ -300,6 +491,34 @@ uint8_t MoToServo::attach(int pinArg, uint16_t pmin, uint16_t pmax ) {
 uint8_t MoToServo::attach( int pinArg, uint16_t pmin, uint16_t pmax, bool autoOff ) {
     // return false if already attached or too many servos
     DB_PRINT("Servoattach: pwmNbr=%d, servoIx=%d, Pin=%d", _servoData.pwmNbr, _servoData.servoIx, pinArg );
+    // a pending detach is completed first
+    #ifdef IS_ESP
+    if ( _servoData.detachReq == SV_DETACH_REQ ) {
+        // the IRQ has not yet stopped the pulses. Stop them here after a running pulse ( the
+        // driver calls to release the pin are not allowed in the IRQ )
+        while ( digitalRead( _servoData.pin ) == HIGH );
+        noInterrupts();
+        _servoData.detachReq = SV_DETACH_OFF;
+        interrupts();
+    }
+    if ( _servoData.detachReq == SV_DETACH_OFF ) _finishDetach();
+    #else
+    // If the last pulse of the servo is still running, it is switched off by the IRQ at its end,
+    // which also releases the old pin.
+    noInterrupts();
+    if ( _servoData.detachReq == SV_DETACH_REQ ) {
+        bool pulseRunning = false;
+        for ( uint8_t ix = 0; ix < activeCnt; ix++ ) pulseRunning |= activePulseP[ix] == &_servoData;
+        if ( pulseRunning && _servoData.releasePin == NO_PIN ) _servoData.releasePin = _servoData.pin;
+        else pinMode( _servoData.pin, INPUT );
+        // a pulse, that has been computed before detach, must not be created at the new pin
+        if ( nextPulseP == &_servoData ) nextPulseDetached = true;
+        _servoData.pin = NO_PIN;
+        _servoData.pwmNbr = NOT_ATTACHED;
+        _servoData.detachReq = SV_DETACH_NONE;
+    }
+    interrupts();
+    #endif
     if ( _servoData.pwmNbr >= 0 /*!= NOT_ATTACHED */ ||  _servoData.servoIx >= MAX_SERVOS ) return 0;
     #ifdef ESP8266 // check pinnumber
         if ( pinArg <0 || pinArg >15 || gpioUsed(pinArg ) ) return 0;
@@ -308,6 +527,7 @@ uint8_t MoToServo::attach( int pinArg, uint16_t pmin, uint16_t pmax, bool autoOf
     // set pulselength for angle 0 and 180
     _minPw = constrain( pmin, MINPULSEWIDTH, MAXPULSEWIDTH );
     _maxPw = constrain( pmax, MINPULSEWIDTH, MAXPULSEWIDTH );
+    _setSlope();
 	DB_PRINT( "pin: %d, pmin:%d pmax%d autoOff=%d", pinArg, pmin, pmax, autoOff);
     
     // intialize objectspecific data
@@ -315,17 +535,37 @@ uint8_t MoToServo::attach( int pinArg, uint16_t pmin, uint16_t pmax, bool autoOf
     _servoData.soll = -1;  // invalid position -> no pulse output
     _servoData.ist = -1;   
     _servoData.inc = 8000;  // means immediate movement
-    _servoData.pin = pinArg;
+    #if SV_CYCLETIME != 20000
+    _servoData.incFrac = 0;
+    _servoData.incAcc = 0;
+    #endif
     _servoData.on = false;  // create no pulses until next write
+    #ifndef IS_ESP
+    _servoData.pulsing = false;
+    #endif
     _servoData.noAutoff = autoOff?0:1 ;  
+    // the IRQ may still switch off the last pulse before attach with these values
+    noInterrupts();
+    _servoData.pin = pinArg;
     #ifdef FAST_PORTWRT
     // compute portaddress and bitmask related to pin number
     _servoData.portAdr = portOutputRegister(digitalPinToPort(pinArg));
     _servoData.bitMask = digitalPinToBitMask(pinArg);
-    DB_PRINT( "Idx: %d Portadr: 0x%x, Bitmsk: 0x%x", _servoData.servoIx, _servoData.portAdr, _servoData.bitMask );
 	#endif
-    pinMode (_servoData.pin,OUTPUT);
-    digitalWrite( _servoData.pin,LOW);
+    #ifndef IS_ESP
+    if ( _servoData.releasePin == pinArg ) {
+        // attached to the same pin during the last pulse, the IRQ switches it off at its end
+        _servoData.releasePin = NO_PIN;
+    } else
+    #endif
+    {
+        pinMode (_servoData.pin,OUTPUT);
+        digitalWrite( _servoData.pin,LOW);
+    }
+    interrupts();
+    #ifdef FAST_PORTWRT
+    DB_PRINT( "Idx: %d Portadr: 0x%x, Bitmsk: 0x%x", _servoData.servoIx, _servoData.portAdr, _servoData.bitMask );
+    #endif
     _servoData.pwmNbr = 0; // >= 0 means 'successfully attached' on all architectures ( maybe ocerriten later in this function )
     #ifdef ESP8266
         // assign an ISR to the pin
@@ -353,15 +593,32 @@ uint8_t MoToServo::attach( int pinArg, uint16_t pmin, uint16_t pmax, bool autoOf
 }
 
 void MoToServo::detach()
-{
-    if ( _servoData.pwmNbr == NOT_ATTACHED ) return; // only if servo is attached
-    byte tPin = _servoData.pin;
-    while( digitalRead( _servoData.pin ) ); // don't detach during an active pulse
+{   // don't wait for the end of an active pulse. The detach is completed in the IRQ
+    #ifdef IS_ESP
+    if ( _servoData.detachReq == SV_DETACH_OFF ) _finishDetach();  // pulses have been stopped in IRQ
+    #endif
+    if ( !attached() ) return; // only if servo is attached
     noInterrupts();
+    #ifdef IS_ESP
+    // the IRQ is only called if pulses are created
+    bool pulsesOn = _servoData.soll >= 0 && (_servoData.offcnt+_servoData.noAutoff) > 0;
+    _servoData.detachReq = pulsesOn ? SV_DETACH_REQ : SV_DETACH_OFF;
+    #else
+    _servoData.detachReq = SV_DETACH_REQ;
+    #endif
     _servoData.on = false;  
     _servoData.soll = -1;  
     _servoData.ist = -1;  
     interrupts();
+    #ifdef IS_ESP
+    if ( _servoData.detachReq == SV_DETACH_OFF ) _finishDetach();
+    #endif
+}
+
+#ifdef IS_ESP
+void MoToServo::_finishDetach() {
+    // pulses have been stopped, release pin and pwm channel
+    byte tPin = _servoData.pin;
     #ifdef ESP8266
         stopWaveformMoTo(tPin); //stop creating pulses
         clrGpio(tPin);
@@ -373,72 +630,133 @@ void MoToServo::detach()
     pinMode( tPin, INPUT );
     _servoData.pwmNbr = NOT_ATTACHED;  
     _servoData.pin = NO_PIN;  
+    _servoData.detachReq = SV_DETACH_NONE;
 }
+#endif
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-but-set-variable"  // because of startPulse in NON esp8266 use
 void MoToServo::write(uint16_t angleArg)
 {   // set position to move to
     // values between 0 and 180 are interpreted as degrees,
     // values between MINPULSEWIDTH and MAXPULSEWIDTH are interpreted as microseconds
-    static int newpos;
-    bool startPulse = false;    // only for esp8266
     //SET_TP1;
     #ifdef ARDUINO_ARCH_AVR
         //DB_PRINT( "Write: angleArg=%d, Soll=%d, OCR=%u", angleArg, _servoData.soll, OCRxA );
     #endif
-    if ( _servoData.pwmNbr != NOT_ATTACHED ) { // only if servo is attached
+    if ( attached() ) { // only if servo is attached
         //Serial.print( "Pin:" );Serial.print (_servoData.pin);Serial.print("Wert:");Serial.println(angleArg);
         #ifdef ARDUINO_ARCH_AVR
 		//DB_PRINT( "Stack=0x%04x, &sIx=0x%04x", ((SPH&0x7)<<8)|SPL, &_servoData.servoIx );
         #endif
-        if ( angleArg <= 255) {
-            // pulse width as degrees (byte values are always degrees) 09-02-2017
-            angleArg = min( 180,(int)angleArg);
-            newpos = time2tic( map( angleArg, 0,180, _minPw, _maxPw ) );
-        } else {
-            // pulsewidth as microseconds
-            newpos = time2tic( constrain( angleArg, _minPw, _maxPw ) );
-            
-        }
-        if ( _servoData.soll < 0 ) {
-            // Serial.println( "first write");
-            // this is the first pulse to be created after attach
-            _servoData.on = true;
-            startPulse = true;      // only for esp8266
-            _lastPos = newpos;
+        _setPos( _angle2pos( angleArg ), 0, 0 );
+    }
+    //DB_PRINT( "Soll=%d, Ist=%d, Ix=%d, inc=%d, SR=%d, Duty100=%d, LEDC_BITS=%d", _servoData.soll,_servoData.ist, _servoData.servoIx, _servoData.inc, INC_PER_TIC, DUTY100, LEDC_BITS );
+    DB_PRINT( "Soll=%d, Ist=%d, Ix=%d, inc=%d, SR=%d", _servoData.soll,_servoData.ist, _servoData.servoIx, _servoData.inc, (int)INC_PER_TIC );
+	DB_PRINT( "t2tic=%d, tic2t=%d", (int)time2tic(map( angleArg, 0,180, _minPw, _maxPw)), (int)tic2time(_servoData.soll ) );
+    //delay(2);
+    //CLR_TP1;
+}
+
+int MoToServo::_angle2pos( uint16_t angleArg ) {
+    // convert argument of write() to position in increments
+    if ( angleArg <= 255) {
+        // pulse width as degrees (byte values are always degrees) 09-02-2017
+        if ( angleArg > 180 ) angleArg = 180;
+        return _minPos + (int)( ( angleArg * _posSlope + 0x8000 ) >> 16 );
+    } else {
+        // pulsewidth as microseconds
+        return time2tic( constrain( angleArg, _minPw, _maxPw ) );
+    }
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"  // because of startPulse in NON esp8266 use
+void MoToServo::_setPos( int newpos, uint16_t groupInc, uint8_t groupStart ) {
+    // set new target position. groupInc != 0: movement of a servo group, that starts
+    // in cycle 'groupStart' and increments easePhase by groupInc
+    bool startPulse = false;    // only for esp8266
+    if ( _servoData.soll < 0 ) {
+        // Serial.println( "first write");
+        // this is the first pulse to be created after attach
+        _servoData.on = true;
+        startPulse = true;      // only for esp8266
+        _lastPos = newpos;
+        noInterrupts();
+        _servoData.soll= newpos ; 
+        _servoData.ist= newpos ; // .ist =.soll  -> will jump to .soll immediately
+        interrupts();
+        
+    }
+    else if ( newpos != _servoData.soll || groupInc != 0 ) {
+        // position has changed, store old position, set new position
+        _lastPos = _servoData.soll;
+        if ( groupInc != 0 ) {
             noInterrupts();
-            _servoData.soll= newpos ; 
-            _servoData.ist= newpos ; // .ist =.soll  -> will jump to .soll immediately
+            _lastPos = _servoData.ist;  // the servo may still be moving
+            _servoData.soll = newpos;
+            _servoData.easeFrom = _servoData.ist;
+            _servoData.easePhase = 0;
+            _servoData.easeInc = groupInc;
+            _servoData.easeStart = groupStart;
+            _servoData.moveEasing = _servoData.easing;
             interrupts();
-            
-        }
-        else if ( newpos != _servoData.soll ) {
-            // position has changed, store old position, set new position
-            _lastPos = _servoData.soll;
+        } else if ( _servoData.easing != EASE_LINEAR ) {
+            _setSollEased( newpos, _servoData.easing );
+        } else {
             noInterrupts();
             _servoData.soll= newpos ;
+            _servoData.easeInc = 0;     // linear movement with inc
             interrupts();
         }
-        #ifdef IS_ESP // start creating pulses?
-            if ( (startPulse) || (_servoData.offcnt+_servoData.noAutoff) == 0  ) {
-                SET_TP3;
-                // first pulse after attach, or pulses have been switch off by autoff
-                startServoPulse( &_servoData, _servoData.ist/INC_PER_TIC);
-                DB_PRINT( "start pulses at pin %d, ist=%d, soll=%d", _servoData.pin, _servoData.ist, _servoData.soll );
-                CLR_TP3;
-            }
-        #endif
-        _servoData.offcnt = OFF_COUNT;   // auf jeden Fall wieder Pulse ausgeben
     }
-    //DB_PRINT( "Soll=%d, Ist=%d, Ix=%d, inc=%d, SR=%d, Duty100=%d, LEDC_BITS=%d", _servoData.soll,_servoData.ist, _servoData.servoIx, _servoData.inc, INC_PER_TIC, DUTY100, LEDC_BITS );
-    DB_PRINT( "Soll=%d, Ist=%d, Ix=%d, inc=%d, SR=%d", _servoData.soll,_servoData.ist, _servoData.servoIx, _servoData.inc, (int)INC_PER_TIC );
-	DB_PRINT( "t2tic=%d, tic2t=%d", (int)time2tic(map( angleArg, 0,180, _minPw, _maxPw)), (int)tic2time(_servoData.soll ) );
-    //delay(2);
-    //CLR_TP1;
+    #ifdef IS_ESP // start creating pulses?
+        if ( (startPulse) || (_servoData.offcnt+_servoData.noAutoff) == 0  ) {
+            SET_TP3;
+            // first pulse after attach, or pulses have been switch off by autoff
+            startServoPulse( &_servoData, _servoData.ist/INC_PER_TIC);
+            DB_PRINT( "start pulses at pin %d, ist=%d, soll=%d", _servoData.pin, _servoData.ist, _servoData.soll );
+            CLR_TP3;
+        }
+    #endif
+    _servoData.offcnt = OFF_COUNT;   // auf jeden Fall wieder Pulse ausgeben
 }
 #pragma GCC diagnostic pop
 
+void MoToServo::_setSollEased( int newpos, uint8_t type ) {
+    // set new target position and start the easing curve at the actual position.
+    // The movement lasts as long as the linear movement with the same speed
+    int ist;
+    uint16_t easeInc = 0xffff;      // means immediate movement
+    noInterrupts();
+    ist = _servoData.ist;
+    interrupts();
+    long dist = abs( newpos - ist );
+    #if SV_CYCLETIME != 20000
+    uint32_t inc = incFix( _servoData );
+    if ( dist > 0 && inc < ( (uint32_t)dist << 16 ) ) {
+        easeInc = ( inc + dist/2 ) / dist;
+    #else
+    if ( dist > 0 && _servoData.inc < dist ) {
+        easeInc = ( ( (long)_servoData.inc << 16 ) + dist/2 ) / dist;
+    #endif
+        if ( easeInc == 0 ) easeInc = 1;
+    }
+    noInterrupts();
+    _servoData.soll = newpos;
+    _servoData.easeFrom = _servoData.ist;
+    _servoData.easePhase = 0;
+    _servoData.easeInc = easeInc;
+    _servoData.easeStart = servoCycle;
+    _servoData.moveEasing = type;
+    interrupts();
+}
+
+void MoToServo::setEasing( uint8_t type ) {
+    // set easing profile. A running movement is continued with the new profile
+    if ( type > EASE_BOUNCE ) type = EASE_LINEAR;
+    _servoData.easing = type;
+    if ( type != EASE_LINEAR && _servoData.soll >= 0 ) _setSollEased( _servoData.soll, type );
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 void MoToServo::setSpeedTime(uint16_t minMaxTime ) {
@@ -465,23 +783,33 @@ void MoToServo::setSpeed( int speed, bool compatibility ) {
 void MoToServo::setSpeed( int speed ) {
     // Set increment value for movement to new angle
     // 'speed' is 0,125µs increment per 20ms
-    if ( _servoData.pwmNbr != NOT_ATTACHED ) { // only if servo is attached
+    if ( attached() ) { // only if servo is attached
         if ( speedV08 ) speed *= COMPAT_FACT;
         speed = constrain(  speed, 0, 8000 );  // 8000 means immediate movement, greater values make no sense
                                         // Greater Values will also lead to an overflow on ESP32
+        #if SV_CYCLETIME != 20000
+        // convert to increment per servo cycle with a fraction of 1/65536
+        uint32_t incCyc = (uint32_t)AS_Speed2Inc( speed == 0 ? 8000 : speed ) * SV_CYCLETIME;   // * 20000
+        uint16_t incFrac = ( ( incCyc % 20000 << 16 ) + 10000 ) / 20000;
+        noInterrupts();
+        _servoData.inc = incCyc / 20000;
+        _servoData.incFrac = incFrac;
+        interrupts();
+        #else
         noInterrupts();
         if ( speed == 0 )
             _servoData.inc = AS_Speed2Inc(8000);  // means immediate movement
         else
             _servoData.inc = AS_Speed2Inc(speed);
         interrupts();
+        #endif
     }
 }
 
 uint8_t MoToServo::read() {
     // get position in degrees
     int offset;
-    if ( _servoData.pwmNbr == NOT_ATTACHED ) return -1; // Servo not attached
+    if ( !attached() ) return -1; // Servo not attached
     offset = (_maxPw - _minPw)/180/2;
     return map( readMicroseconds() + offset, _minPw, _maxPw, 0, 180 );
 }
@@ -489,7 +817,7 @@ uint8_t MoToServo::read() {
 uint16_t MoToServo::readMicroseconds() {
     // get position in microseconds
     int value;
-    if ( _servoData.pwmNbr == NOT_ATTACHED ) return -1; // Servo not attached
+    if ( !attached() ) return -1; // Servo not attached
     noInterrupts();
     value = _servoData.ist;
     interrupts();
@@ -498,12 +826,59 @@ uint16_t MoToServo::readMicroseconds() {
     return tic2time( value );   
 }
 
+uint16_t MoToServo::readPosition() {
+    // get position in 1/8 microseconds
+    int value;
+    if ( !attached() ) return -1; // Servo not attached
+    noInterrupts();
+    value = _servoData.ist;
+    interrupts();
+    if ( value < 0 ) value = _servoData.soll; // there is no valid actual vlaue
+    return pos2eighth( value );
+}
+
+uint16_t MoToServo::arrivalTime() {
+    // predict the end of the running movement from the state of the IRQ
+    if ( !attached() ) return 0; // Servo not attached
+    int ist, soll, inc;
+    uint16_t easePhase, easeInc;
+    uint32_t cycles = 0;
+    int8_t startDelay = 0;
+    noInterrupts();
+    ist = _servoData.ist;
+    soll = _servoData.soll;
+    #if SV_CYCLETIME != 20000
+    uint32_t incF = incFix( _servoData );
+    #endif
+    inc = _servoData.inc;
+    easePhase = _servoData.easePhase;
+    easeInc = _servoData.easeInc;
+    #ifndef IS_ESP
+    startDelay = _servoData.easeStart - servoCycle;   // group movement may not have started yet
+    #endif
+    interrupts();
+    if ( ist < 0 || ist == soll ) return 0;    // there is no movement
+    if ( easeInc != 0 ) {
+        cycles = ( 0xffffUL - easePhase + easeInc - 1 ) / easeInc;
+        if ( startDelay > 0 ) cycles += startDelay;
+    } else {
+        #if SV_CYCLETIME != 20000
+        cycles = ( ( (uint32_t)abs( soll - ist ) << 16 ) + incF - 1 ) / incF;
+        (void)inc;
+        #else
+        cycles = ( (uint32_t)abs( soll - ist ) + inc - 1 ) / inc;
+        #endif
+    }
+    cycles = ( cycles * SV_CYCLETIME + 999 ) / 1000;    // convert to ms
+    return cycles > 0xffff ? 0xffff : cycles;
+}
+
 uint8_t MoToServo::moving() {
     // return how much still to move (percentage)
-    if ( _servoData.pwmNbr == NOT_ATTACHED ) return 0; // Servo not attached
+    if ( !attached() ) return 0; // Servo not attached
     long total , remaining;
+    noInterrupts(); // disable interrupt, because ist, soll and _lastPos are changed in interrupt ( sequences )
     total = abs( _lastPos - _servoData.soll );
-    noInterrupts(); // disable interrupt, because integer _servoData.ist is changed in interrupt
     remaining = abs( _servoData.soll - _servoData.ist );
     interrupts();  // allow interrupts again
     if ( remaining == 0 ) return 0;
@@ -511,8 +886,151 @@ uint8_t MoToServo::moving() {
 }
 
 uint8_t MoToServo::attached()
-{
-    return ( _servoData.pwmNbr != NOT_ATTACHED );
+{   // a servo with a pending detach request is not attached anymore
+    return ( _servoData.pwmNbr != NOT_ATTACHED && _servoData.detachReq == SV_DETACH_NONE );
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// --------- Class MoToServoGroup ---------------------------------
+MoToServoGroup::MoToServoGroup( MoToServo *servos[], uint8_t count ) {
+    _servos = servos;
+    _count = count;
+    #ifndef IS_ESP
+    _power.pin = NO_PIN;
+    #endif
+}
+
+#ifndef IS_ESP
+void MoToServoGroup::powerPin( uint8_t pin, uint8_t onLevel ) {
+    // the power is switched on in the servo IRQ before the first pulse of a servo of the group
+    // is created, and switched off, if no servo of the group creates pulses anymore.
+    if ( _power.pin != NO_PIN ) return;   // power pin can be set only once
+    _power.pin = pin;
+    _power.onLevel = onLevel;
+    _power.on = false;
+    _power.needed = false;
+    digitalWrite( pin, !onLevel );
+    pinMode( pin, OUTPUT );
+    noInterrupts();
+    for ( uint8_t i = 0; i < _count; i++ ) _servos[i]->_servoData.powerP = &_power;
+    _power.prevPowerP = lastPowerP;
+    lastPowerP = &_power;
+    interrupts();
+}
+#endif
+
+void MoToServoGroup::moveTo( const uint16_t targets[], uint16_t timeMs ) {
+    // all servos get the same phase increment and start in the same cycle, so they arrive
+    // at the same time.
+    uint32_t cycles = ( (uint32_t)timeMs * 1000 ) / SV_CYCLETIME;
+    if ( cycles == 0 ) cycles = 1;
+    uint16_t groupInc = cycles > 0xffff ? 1 : ( 0xffffUL + cycles - 1 ) / cycles;
+    // start in the next but one cycle, so it is the same for all servos, even if 
+    // the cycle changes while setting the servos
+    uint8_t groupStart = servoCycle + 2;
+    for ( uint8_t i = 0; i < _count; i++ ) {
+        MoToServo *servoP = _servos[i];
+        if ( servoP->attached() ) {
+            servoP->_setPos( servoP->_angle2pos( targets[i] ), groupInc, groupStart );
+        }
+    }
 }
 
+uint8_t MoToServoGroup::moving() {
+    uint8_t maxMoving = 0;
+    for ( uint8_t i = 0; i < _count; i++ ) {
+        uint8_t m = _servos[i]->moving();
+        if ( m > maxMoving ) maxMoving = m;
+    }
+    return maxMoving;
+}
 
+#ifndef IS_ESP
+///////////////////////////////////////////////////////////////////////////////////
+// --------- Class MoToServoSequence ---------------------------------
+MoToServoSequence::MoToServoSequence( MoToServo *servos[], uint8_t count, const servoKeyframe_t *keyframes ) {
+    _servos = servos;
+    _count = count;
+    _keyframes = keyframes;
+    _kfIx = 0;
+    _waitCnt = 0;
+    _running = false;
+    _loop = false;
+    noInterrupts();
+    _prevSeqP = lastSeqP;
+    lastSeqP = this;
+    interrupts();
+}
+
+void MoToServoSequence::play( bool loop ) {
+    // the first keyframe is started at the next servo cycle
+    noInterrupts();
+    _kfIx = 0;
+    _waitCnt = 0;
+    _loop = loop;
+    _running = true;
+    interrupts();
+}
+
+void MoToServoSequence::stop() {
+    _running = false;
+}
+
+bool MoToServoSequence::playing() {
+    return _running;
+}
+
+uint16_t MoToServoSequence::keyframe() {
+    noInterrupts();
+    uint16_t kfIx = _kfIx;
+    interrupts();
+    return kfIx;
+}
+
+void MoToServoSequence::_tick() {
+    // runs in the servo IRQ at the start of a cycle, no servo pulse is active.
+    // Start all keyframes that are due in this cycle.
+    if ( _waitCnt > 0 ) {
+        _waitCnt--;
+        return;
+    }
+    while ( true ) {
+        const servoKeyframe_t *kfP = &_keyframes[_kfIx];
+        uint8_t servoIx = pgm_read_byte( &kfP->servo );
+        if ( servoIx == SEQ_END ) {
+            if ( _loop ) {
+                _kfIx = 0;  // the first keyframe starts in the next cycle
+            } else {
+                _running = false;
+            }
+            return;
+        }
+        _kfIx++;
+        if ( servoIx < _count ) {
+            MoToServo *servoP = _servos[servoIx];
+            servoData_t *dataP = &servoP->_servoData;
+            if ( servoP->attached() ) {
+                int newpos = servoP->_angle2pos( pgm_read_word( &kfP->target ) );
+                dataP->moveEasing = pgm_read_byte( &kfP->easing );   // the profile of setEasing() is kept
+                if ( dataP->soll < 0 ) {
+                    // first position after attach, jump to it
+                    dataP->on = true;
+                    dataP->ist = newpos;
+                }
+                servoP->_lastPos = dataP->ist;
+                dataP->soll = newpos;
+                dataP->easeFrom = dataP->ist;
+                dataP->easePhase = 0;
+                dataP->easeInc = pgm_read_word( &kfP->easeInc );
+                dataP->easeStart = servoCycle;
+                dataP->offcnt = OFF_COUNT;
+            }
+        }
+        _waitCnt = pgm_read_word( &kfP->waitCycles );
+        if ( _waitCnt > 0 ) {
+            _waitCnt--;     // this cycle is the first one to wait
+            return;
+        }
+    }
+}
+#endif
@@ -16,18 +16,64 @@
 // defines for servos
 #define Servo2	MoToServo		// Kompatibilität zu Version 01 und 02
 #define AUTOOFF 1               // 2nd Parameter for servo.attach to switch off pulses in standstill
+// easing profiles for setEasing()
+#define EASE_LINEAR     0       // constant speed ( default )
+#define EASE_IN         1       // quadratic, starting slowly
+#define EASE_OUT        2       // quadratic, ending slowly
+#define EASE_INOUT      3       // smooth start and end
+#define EASE_CUBIC      4       // cubic in/out, stronger than EASE_INOUT
+#define EASE_BOUNCE     5       // bounces back at the end ( e.g. semaphore arm )
 #define OVLMARGIN           280     // Overlap margin ( Overlap is MINPULSEWIDTH - OVLMARGIN )
 #define OVL_TICS       ( ( MINPULSEWIDTH - OVLMARGIN ) * TICS_PER_MICROSECOND )
 #define MARGINTICS      ( OVLMARGIN * TICS_PER_MICROSECOND )
-#define MAX_SERVOS  16  
+#define OFFMARGIN           100     // min. distance between the ends of 2 overlapping pulses ( max IRQ time )
+#define OFFMARGINTICS   ( OFFMARGIN * TICS_PER_MICROSECOND )
+#if MAX_SERVOS > 63
+    #error "MAX_SERVOS must not exceed 63"
+#endif
+#if defined ARDUINO_ARCH_ESP32 && MAX_SERVOS > 16
+    #error "MAX_SERVOS must not exceed 16 on ESP32 ( 16 LEDC channels )"
+#endif
+#if SERVO_CYCLETIME < 3000 || SERVO_CYCLETIME > 20000
+    #error "SERVO_CYCLETIME must be within 3000 ... 20000"
+#endif
+#ifdef ARDUINO_ARCH_ESP32
+#define SV_CYCLETIME    20000   // servo cycle in µs, fixed on ESP32 ( see SERVO_FREQ )
+#else
+#define SV_CYCLETIME    SERVO_CYCLETIME
+#endif
 
 #define MINPULSETICS    (MINPULSEWIDTH * TICS_PER_MICROSECOND)
 #define MAXPULSETICS    (MAXPULSEWIDTH * TICS_PER_MICROSECOND)
 
-#define OFF_COUNT       50  // if autoOff is set, a pulse is switched off, if it length does not change for
-                            // OFF_COUNT cycles ( = OFF_COUNT * 20ms )
+#define OFF_COUNT       ( SV_CYCLETIME < 4000 ? 255 : 1000000L / SV_CYCLETIME )
+                            // if autoOff is set, a pulse is switched off, if it length does not change for
+                            // OFF_COUNT cycles ( = about 1 sec )
+// convert position ( increments ) to 1/8 µs
+#ifdef ARDUINO_ARCH_ESP32
+#define pos2eighth(pos)  ( (uint16_t)( ( (uint64_t)(pos) * 8 * SERVO_CYCLE ) / DUTY100 ) )
+#else
+#define pos2eighth(pos)  ( (uint16_t)( (uint32_t)(pos) * 8 / INC_PER_MICROSECOND ) )
+#endif
+
+// state of a detach request. detach() doesn't wait for the end of a running pulse, this is done in the IRQ
+#define SV_DETACH_NONE  0
+#define SV_DETACH_REQ   1   // detach requested, waiting for the end of the pulse
+#define SV_DETACH_OFF   2   // pulses are stopped, pin is released at next call of attach/detach ( ESP only )
 #define FIRST_PULSE     100 // first pulse starts 200 tics after timer overflow, so we do not compete
                             // with overflow IRQ
+#ifndef IS_ESP
+// Worst case: all servos at MAXPULSEWIDTH. Every overlapping pulse chain gets MAX_SERVOS/SERVO_OVERLAP
+// pulses ( rounded up ), +10s per pulse for the IRQ that starts it. The chains are shifted by OFFMARGIN
+// against each other ( pulse ends ), and the last one must end OVLMARGIN before the end of the cycle
+// ( checked with extras/hostsim/tools/servo_pulse -w )
+#define SV_CHAINPULSES  ( ( MAX_SERVOS + SERVO_OVERLAP - 1 ) / SERVO_OVERLAP )
+#if SERVO_OVERLAP < 2
+    #error "SERVO_OVERLAP must be at least 2"
+#elif SV_CHAINPULSES*(MAXPULSEWIDTH+10) + (SERVO_OVERLAP-1)*OFFMARGIN > SERVO_CYCLETIME-OVLMARGIN-FIRST_PULSE
+    #error "SERVO_OVERLAP is too small for MAX_SERVOS and SERVO_CYCLETIME"
+#endif
+#endif
 
 /* Regarding servo Speed:
 One 'Speed tic' in setSpeed should be about 0.125 µs. That's not the real timer tic. So in reality the 
@@ -50,6 +96,15 @@ Pulse length are always stored in inc. Only when creating the real pulse ( in IR
 //void ISR_Servo( void *arg );
 
 // global servo data ( used in ISR )
+// power rail of a servo group, switched in the servo IRQ ( not ESP )
+struct servoPower_t {
+  struct servoPower_t* prevPowerP;  // chain of power rails ( used in IRQ )
+  uint8_t pin;          // power enable pin
+  uint8_t onLevel;      // HIGH or LOW: pin level to switch the power on
+  volatile bool on;     // power is switched on
+  bool needed;          // a servo of this rail creates pulses ( in the actual pass of the servo chain )
+};
+
 struct servoData_t {
   struct servoData_t* prevServoDataP;
   uint8_t servoIx :6 ;  // Servo number. On ESP32 this is also the nuber of  the PWM timer
@@ -59,13 +114,36 @@ struct servoData_t {
   int soll;             // Position, die der Servo anfahren soll ( in Tics ). -1: not initialized
   volatile int ist;     // Position, die der Servo derzeit einnimt ( in Tics )
   int inc;              // Schrittweite je Zyklus um Ist an Soll anzugleichen( in Tics )
+  #if SV_CYCLETIME != 20000
+  uint16_t incFrac;     // fraction of inc ( 1/65536 ), so the speed per 20ms is exact with shorter cycles
+  uint16_t incAcc;      // sum of the fractions, the overflow is added to ist
+  #endif
   uint8_t offcnt;       // counter to switch off pulses if length doesn't change
+  uint8_t easing;       // easing profile for the next movements ( EASE_LINEAR ... )
+  uint8_t moveEasing;   // easing profile of the running movement ( setEasing or keyframe )
+  uint16_t easePhase;   // progress of movement with easing ( 0...0xffff )
+  uint16_t easeInc;     // increment of easePhase per cycle ( 0: linear movement with 'inc' )
+  uint8_t easeStart;    // servo cycle when the movement starts ( group movements, not ESP )
+  int easeFrom;         // starting point of movement with easing
   #ifdef FAST_PORTWRT
   volatile uint8_t* portAdr;     // port adress related to pin number
   volatile uint8_t  bitMask;     // bitmask related to pin number
   #endif
   uint8_t pin     ;     // pin
   int8_t pwmNbr;        // pwm channel on ESP32 , -1 means not attached on all platforms
+  volatile uint8_t detachReq;   // state of a detach request ( SV_DETACH_... )
+  #ifndef IS_ESP
+  servoPower_t* powerP; // power rail of the servo ( NULL: no power switching )
+  uint8_t pulsing;      // servo created pulses in the last cycle
+  uint8_t releasePin;   // old pin, that is released at the end of its running pulse ( attach during a pulse )
+  #endif
+  #if defined MOTO_STATS && !defined IS_ESP
+  uint16_t pulseOn;     // timer count at start of the running pulse
+  uint16_t pulseLen;    // computed length of the running pulse ( timer tics )
+  int16_t minPulseErr;  // min/max deviation of the real pulse length ( timer tics )
+  int16_t maxPulseErr;
+  uint16_t badPulses;   // nbr of pulses with a deviation of more than 1µs
+  #endif
 } ;
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -77,7 +155,19 @@ class MoToServo
     //uint8_t _angle;       // in degrees
     uint16_t _minPw;       // minimum pulse, uS units  
     uint16_t _maxPw;       // maximum pulse, uS units
+    int _minPos;           // position at 0° ( in increments )
+    long _posSlope;        // increments per degree ( fixed point 16.16, negative if _minPw > _maxPw )
+    void _setSlope();      // compute _minPos and _posSlope from _minPw and _maxPw
     servoData_t _servoData;  // Servo data to be used in ISR
+    void _setSollEased( int newpos, uint8_t type ); // set new position for a movement with easing
+    int _angle2pos( uint16_t angle );   // convert argument of write() to position
+    void _setPos( int newpos, uint16_t groupInc, uint8_t groupStart ); // set new position
+    #ifdef IS_ESP
+    void _finishDetach();               // release pin and pwm channel after pulses have been stopped
+    #endif
+    friend class MoToServoGroup;
+    friend class MoToServoSequence;
+    friend class MoToStats;
 
 	public:
     // don't allow copying and moving of Servo objects
@@ -101,14 +191,89 @@ class MoToServo
     #define HIGHRES 0
     #define SPEEDV08 1
 	void setSpeedTime(uint16_t  );  // set Speed as time between 0...180° in milliseconds
+    void setEasing( uint8_t type ); // set easing profile for the next movements ( EASE_LINEAR ... EASE_BOUNCE )
+                                    // the duration of a movement is the same as with EASE_LINEAR
     
     uint8_t moving();        // returns the remaining Way to the angle last set with write() in
                              // in percentage. '0' means, that the angle is reached
     uint8_t read();          // current position in degrees (0...180)
     uint16_t  readMicroseconds();// current pulsewidth in microseconds
+    uint16_t readPosition();        // current pulsewidth in 1/8 microseconds
+    uint16_t arrivalTime();         // time in ms until the servo reaches the target ( 0: target reached )
     uint8_t attached();
     void setMinimumPulse(uint16_t);  // pulse length for 0 degrees in microseconds, 700uS default
     void setMaximumPulse(uint16_t);  // pulse length for 180 degrees in microseconds, 2300uS default
 };
 
+////////////////////////////////////////////////////////////////////////////////////////
+// group of servos, that are moved synchronously: all servos of the group start and arrive at the
+// same time ( in the same servo cycle. On ESP there may be a difference of one cycle ).
+// The easing profiles of the servos are used for the movement.
+class MoToServoGroup
+{
+  private:
+    MoToServo **_servos;    // array of servos ( provided by the sketch )
+    uint8_t _count;         // number of servos in the group
+    #ifndef IS_ESP
+    servoPower_t _power;    // power rail of the group
+    #endif
+    
+  public:
+    MoToServoGroup( MoToServo *servos[], uint8_t count );
+    #ifndef IS_ESP
+    void powerPin( uint8_t pin, uint8_t onLevel = HIGH ); // switch power of the group with pin. The power is
+                            // on as long as one of the servos creates pulses ( see autoOff )
+    #endif
+    void moveTo( const uint16_t targets[], uint16_t timeMs ); // move all servos within timeMs milliseconds
+                            // targets are interpreted as in write(): degrees or microseconds
+    uint8_t moving();       // remaining way of the servo, that is farthest from its target ( percentage )
+};
+
+#ifndef IS_ESP
+////////////////////////////////////////////////////////////////////////////////////////
+// keyframe sequences for servos, stored in flash and played in the servo IRQ ( not on ESP )
+// A keyframe starts a movement of one servo. All keyframes with waitMs = 0 start in the same
+// cycle as the next keyframe, so they are moved synchronously.
+struct servoKeyframe_t {
+  uint8_t  servo;       // index in the servo array of the sequence, SEQ_END: end of sequence
+  uint8_t  easing;      // easing profile for this movement
+  uint16_t target;      // target position as in write(): degrees or microseconds
+  uint16_t easeInc;     // phase increment per cycle ( computed by SERVO_KEYFRAME )
+  uint16_t waitCycles;  // servo cycles until the next keyframe ( computed by SERVO_KEYFRAME )
+};
+#define SEQ_END         0xff
+#define SV_MS2CYCLES(ms)    ( (uint32_t)(ms) * 1000 / SV_CYCLETIME )
+#define SV_MS2EASEINC(ms)   ( SV_MS2CYCLES(ms) == 0 ? 0xffff : (uint16_t)( ( 0xffffUL + SV_MS2CYCLES(ms) - 1 ) / SV_MS2CYCLES(ms) ) )
+// keyframe: move servo ( index ) to target within timeMs with easing, start next keyframe after waitMs
+#define SERVO_KEYFRAME( servo, target, timeMs, easing, waitMs ) \
+        { servo, easing, target, SV_MS2EASEINC(timeMs), (uint16_t)SV_MS2CYCLES(waitMs) }
+#define SERVO_SEQEND    { SEQ_END, 0, 0, 0, 0 }
+
+class MoToServoSequence
+{
+  private:
+    MoToServo **_servos;                // array of servos ( provided by the sketch )
+    uint8_t _count;                     // number of servos
+    const servoKeyframe_t *_keyframes;  // keyframes in PROGMEM, terminated by SERVO_SEQEND
+    volatile uint16_t _kfIx;            // next keyframe
+    volatile uint16_t _waitCnt;         // cycles until next keyframe
+    volatile bool _running;
+    bool _loop;                         // restart at the end of the sequence
+    MoToServoSequence *_prevSeqP;       // chain of sequences ( used in IRQ )
+    void _tick();                       // called in IRQ at the start of every servo cycle
+    friend void servoSeqTick();
+    
+  public:
+    // don't allow copying and moving of sequence objects
+    MoToServoSequence &operator= (const MoToServoSequence & )   =delete;
+    MoToServoSequence (const MoToServoSequence & )              =delete;
+
+    MoToServoSequence( MoToServo *servos[], uint8_t count, const servoKeyframe_t *keyframes );
+    void play( bool loop = false );     // start the sequence from the beginning
+    void stop();                        // stop the sequence ( running movements are finished )
+    bool playing();                     // true while the sequence is running
+    uint16_t keyframe();                // index of the next keyframe
+};
+#endif
+
 #endif
\ No newline at end of file
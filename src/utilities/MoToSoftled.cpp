@@ -21,42 +21,136 @@
 static ledData_t* ledRootP = NULL; //start of _ledData-chain
 static uint8_t ledNextCyc = TIMERPERIODE  / CYCLETIME;     // next Cycle that is relevant for leds
 static uint8_t ledCycleCnt = 0;    // count IRQ cycles within PWM cycle
+#ifndef SOFTLED_BAM
+static uint8_t ledPhaseNext = 0;   // phase of the next attached led
+#endif
 
 static ledData_t*  ledDataP;              // pointer to active Led in ISR
+static MoToLedEffect *lastEffectP = NULL;   // start of effect-chain
+
+void ledEffectTick() {
+    // advance all running effects. Called at the start of a PWM cycle
+    for ( MoToLedEffect *effP = lastEffectP; effP != NULL; effP = effP->_prevEffP ) {
+        if ( effP->_running ) effP->_tick();
+    }
+}
+
+static inline uint8_t ledCycles( ledData_t *ledP, uint8_t tmpIx ) {
+    // length of the next PWM pulse ( IRQ cycles ) of a rising/falling led
+    uint8_t cycles;
+    #ifdef SOFTLED_DITHER
+    // compute in 1/16 cycles, interpolated between the steps. The remainder is added to the next pulse
+    uint16_t fine;
+    uint8_t frac = ledP->aStep & (DELTASTEPS-1);
+    switch ( ledP->state ) {
+      case INCBULB:
+      case DECBULB: {
+        uint8_t c0 = pgm_read_byte(&(iSteps[tmpIx]));
+        uint8_t c1 = tmpIx < LED_IX_MAX ? pgm_read_byte(&(iSteps[tmpIx+1])) : LED_CYCLE_MAX;
+        fine = c0 * DITHERSTEPS + ( ( c1 - c0 ) * frac ) / ( DELTASTEPS / DITHERSTEPS );
+        break;
+      }
+      case INCGAMMA:
+      case DECGAMMA: {
+        uint16_t g0 = pgm_read_word(&(gammaSteps[tmpIx]));
+        fine = g0 + ( ( pgm_read_word(&(gammaSteps[tmpIx+1])) - g0 ) * frac ) / DELTASTEPS;
+        break;
+      }
+      default: // linear
+        fine = ledP->aStep / ( DELTASTEPS / DITHERSTEPS );
+    }
+    if ( ledP->state == DECBULB || ledP->state == DECLIN || ledP->state == DECGAMMA ) {
+        fine = LED_CYCLE_MAX * DITHERSTEPS - fine;
+    }
+    fine += ledP->ditherErr;
+    ledP->ditherErr = fine & (DITHERSTEPS-1);
+    cycles = fine / DITHERSTEPS;
+    #else
+    switch ( ledP->state ) {
+      case INCBULB:
+        cycles = pgm_read_byte(&(iSteps[tmpIx]));
+        break;
+      case DECBULB:
+        cycles = LED_CYCLE_MAX-pgm_read_byte(&(iSteps[tmpIx]));
+        break;
+      case INCGAMMA:
+        cycles = pgm_read_word(&(gammaSteps[tmpIx])) / DITHERSTEPS;
+        break;
+      case DECGAMMA:
+        cycles = LED_CYCLE_MAX - pgm_read_word(&(gammaSteps[tmpIx])) / DITHERSTEPS;
+        break;
+      case INCLIN:
+        cycles = tmpIx;
+        break;
+      default: // DECLIN
+        cycles = LED_CYCLE_MAX - tmpIx;
+    }
+    #endif
+    // LED_CYCLE_MAX means 'full on' and ends the rising
+    return cycles < LED_CYCLE_MAX ? cycles : LED_CYCLE_MAX-1;
+}
+#ifdef FAST_PORTWRT
+static ledPort_t* ledPortRootP = NULL;  // start of port chain
+#endif
+
+#ifndef SOFTLED_BAM
+static inline __attribute__((__always_inline__)) void ledPinOn( ledData_t *ledP ) {
+    // switch on the led at the end of the ISR pass ( pin level depends on invFlg )
+    #ifdef FAST_PORTWRT
+    if ( ledP->invFlg ) ledP->ledPortP->clrMask |= ledP->portPin.Mask;
+    else                ledP->ledPortP->setMask |= ledP->portPin.Mask;
+    #else
+    digitalWrite( ledP->pin, !ledP->invFlg );
+    #endif
+}
+
+static inline __attribute__((__always_inline__)) void ledPinOff( ledData_t *ledP ) {
+    #ifdef FAST_PORTWRT
+    if ( ledP->invFlg ) ledP->ledPortP->setMask |= ledP->portPin.Mask;
+    else                ledP->ledPortP->clrMask |= ledP->portPin.Mask;
+    #else
+    digitalWrite( ledP->pin, ledP->invFlg );
+    #endif
+}
+
+static inline __attribute__((__always_inline__)) void ledPortsWrite() {
+    // write all changed leds, every port only once
+    #ifdef FAST_PORTWRT
+    for ( ledPort_t *portP = ledPortRootP; portP != NULL; portP = portP->nextPortP ) {
+        if ( portP->setMask | portP->clrMask ) {
+            noInterrupts(); // the servo IRQ writes to the ports too
+            *portP->adr = ( *portP->adr & ~portP->clrMask ) | portP->setMask;
+            interrupts();
+            portP->setMask = 0;
+            portP->clrMask = 0;
+        }
+    }
+    #endif
+}
+
 void softledISR(uintx8_t cyclesLastIRQ) { // uint8 for AVR, uint32 for 32-Bit processors
     // ---------------------- softleds -----------------------------------------------
+    // Every led starts its pulse at its own phase within the PWM cycle. So the switching edges
+    // and the computing of the next pulselength are spread over the PWM cycle.
+    // evtCyc is the IRQ cycle of the next edge of a led. It may lie in the next PWM cycle
+    // ( evtCyc >= LED_CYCLE_MAX ), if the pulse extends beyond the end of the PWM cycle.
     SET_TP2;
     ledCycleCnt += cyclesLastIRQ;
     if ( ledCycleCnt >= ledNextCyc ) {
         // this IRQ is relevant for softleds
+        TRACE_EVENT( TR_SOFTLED, 0, ledCycleCnt );
+        bool newCycle = ( ledCycleCnt >= LED_CYCLE_MAX );   // start of a new PWM Cycle
+        if ( newCycle && lastEffectP != NULL ) ledEffectTick();
         ledNextCyc = LED_CYCLE_MAX; // there must be atleast one IRQ per PWM Cycle
-        if ( ledCycleCnt >= LED_CYCLE_MAX ) {
-            // start of a new PWM Cycle - switch all leds with rising/falling state to on
-            // When rising, check if full on is reached
-            ledCycleCnt = 0;
-            for ( ledDataP=ledRootP; ledDataP!=NULL; ledDataP = ledDataP->nextLedDataP ) {
-                //SET_TP1;
-                // loop over led-objects
-                switch ( ledDataP->state ) {
-                  case INCBULB:
-                  case INCLIN:
-                    // led with rising brightness
-                    noInterrupts();
-                    if (ledDataP->invFlg  ) {
-                        #ifdef FAST_PORTWRT
-                        *ledDataP->portPin.Adr &= ~ledDataP->portPin.Mask;
-                        #else
-                        digitalWrite( ledDataP->pin, LOW );
-                        #endif
-                    } else { 
-                        #ifdef FAST_PORTWRT
-                        *ledDataP->portPin.Adr |= ledDataP->portPin.Mask;
-                        #else
-                        digitalWrite( ledDataP->pin, HIGH );
-                        #endif
-                    }
-                    interrupts();
-                    // check if led on is reached
+        for ( ledDataP=ledRootP; ledDataP!=NULL; ledDataP = ledDataP->nextLedDataP ) {
+            //SET_TP1;
+            // loop over led-objects
+            if ( ledDataP->evtCyc <= ledCycleCnt ) {
+                // this led has to be switched
+                if ( !ledDataP->actPulse ) {
+                    // start of the pulse ( pulselength may be 0 at the start of rising )
+                    if ( ledDataP->aCycle > 0 ) ledPinOn( ledDataP );
+                    // check if led on is reached ( only when rising )
                     if ( ledDataP->aCycle >=  LED_CYCLE_MAX ) {    // led is full on, remove from active-chain
                         SET_TP4;
                         ledDataP->state = STATE_ON;
@@ -64,121 +158,61 @@ void softledISR(uintx8_t cyclesLastIRQ) { // uint8 for AVR, uint32 for 32-Bit pr
                         if ( ledDataP->nextLedDataP ) ledDataP->nextLedDataP->backLedDataPP = ledDataP->backLedDataPP;
                         ledDataP->aCycle = 0;
                         CLR_TP4;
-                    } else { // set off-time
-                        if ( ledNextCyc > ledDataP->aCycle ) ledNextCyc = ledDataP->aCycle;
-                        ledDataP->actPulse = true;
+                        continue;
                     }
-                    break;
-                  case DECBULB:
-                  case DECLIN:
-                    // led with falling brightness
-                    if (ledDataP->invFlg  ) {
-                        #ifdef FAST_PORTWRT
-                        *ledDataP->portPin.Adr &= ~ledDataP->portPin.Mask;
-                        #else
-                        digitalWrite( ledDataP->pin, LOW );
-                        #endif
-                    } else {
-                        #ifdef FAST_PORTWRT
-                        *ledDataP->portPin.Adr |= ledDataP->portPin.Mask;
-                        #else
-                        digitalWrite( ledDataP->pin, HIGH );
-                        #endif
-                    }
-                    // set off-time 
-                    if ( ledNextCyc > ledDataP->aCycle ) ledNextCyc = ledDataP->aCycle;
+                    // set off-time ( next step is computed in the following IRQ at the latest )
+                    ledDataP->evtCyc += ledDataP->aCycle > 0 ? ledDataP->aCycle : 1;
                     ledDataP->actPulse = true;
-                    break;
-                  default: ;
-                } // end of 'switch'
-                //CLR_TP1;
-            } // end of led loop
-        } else { // is switchofftime within PWM cycle
-            SET_TP3;
-            for ( ledDataP=ledRootP; ledDataP!=NULL; ledDataP = ledDataP->nextLedDataP ) {
-                //SET_TP4;
-                if ( ledDataP->actPulse ) {
-                    // led is within PWM cycle with output high
-                    if ( ledDataP->aCycle <= ledCycleCnt ) {
-                        uint8_t tmpIx;
-                        // End of ON-time is reached
-                        SET_TP4;
-                        if (ledDataP->invFlg  ) {
-                            #ifdef FAST_PORTWRT
-                            *ledDataP->portPin.Adr |= ledDataP->portPin.Mask;
-                            #else
-                            digitalWrite( ledDataP->pin, HIGH );
-                            #endif
-                        } else {
-                            #ifdef FAST_PORTWRT
-                            *ledDataP->portPin.Adr &= ~ledDataP->portPin.Mask;
-                            #else
-                            digitalWrite( ledDataP->pin, LOW );
-                            #endif
+                } else {
+                    uint8_t tmpIx;
+                    // End of ON-time is reached
+                    SET_TP3;
+                    ledPinOff( ledDataP );
+                    ledDataP->actPulse = false; // Led pulse is LOW now
+                    // the next pulse starts at the phase of the led. If the pulse started in this
+                    // PWM cycle, this is in the next PWM cycle
+                    ledDataP->evtCyc = ledDataP->phase + ( ledDataP->evtCyc > ledDataP->phase ? LED_CYCLE_MAX : 0 );
+                    // determine length of next PWM Cyle
+                    ledDataP->aStep += ledDataP->speed;
+                    tmpIx = (ledDataP->aStep/DELTASTEPS);
+                    if ( tmpIx > LED_IX_MAX ) {
+                        // the end is reached
+                        switch ( ledDataP->state ) {
+                          case DECBULB:
+                          case DECLIN:
+                          case DECGAMMA:
+                            // led is off -> remove from chain
+                            ledDataP->state = STATE_OFF;
+                            *ledDataP->backLedDataPP = ledDataP->nextLedDataP;
+                            if ( ledDataP->nextLedDataP ) ledDataP->nextLedDataP->backLedDataPP = ledDataP->backLedDataPP;
+                            CLR_TP3;
+                            continue;
+                          case INCBULB:
+                          case INCLIN:
+                          case INCGAMMA:
+                            // switch permanetly on wirh next cycle
+                            ledDataP->aCycle = LED_CYCLE_MAX;
+                            break;
+                          default:
+                            ;
                         }
-                        CLR_TP4;
-                        ledDataP->actPulse = false; // Led pulse is LOW now
-                        // determine length of next PWM Cyle
-                        //SET_TP1;
-                        SET_TP4;
-                        ledDataP->aStep += ledDataP->speed;
-                        tmpIx = (ledDataP->aStep/DELTASTEPS);
-                        if ( tmpIx > LED_IX_MAX ) {
-                            // the end is reached
-                            CLR_TP4;
-                            switch ( ledDataP->state ) {
-                              case DECBULB:
-                              case DECLIN:
-                                // led is off -> remove from chain
-                                ledDataP->state = STATE_OFF;
-                                *ledDataP->backLedDataPP = ledDataP->nextLedDataP;
-                                if ( ledDataP->nextLedDataP ) ledDataP->nextLedDataP->backLedDataPP = ledDataP->backLedDataPP;
-                                break;
-                              case INCBULB:
-                              case INCLIN:
-                                // switch permanetly on wirh next cycle
-                                ledDataP->aCycle = LED_CYCLE_MAX;
-                                break;
-                              default:
-                                ;
-                            }
-                            SET_TP4;
-                        } else {
-                            // we are still in up/down
-                            CLR_TP4;
-                            switch ( ledDataP->state ) {
-                              case INCBULB:
-                                ledDataP->aCycle = pgm_read_byte(&(iSteps[tmpIx]));
-                                break;
-                              case DECBULB:
-                                //CLR_TP1;
-                                ledDataP->aCycle = LED_CYCLE_MAX-pgm_read_byte(&(iSteps[tmpIx]));
-                                //SET_TP1;
-                                break;
-                              case INCLIN:
-                                ledDataP->aCycle = tmpIx;
-                                break;
-                              case DECLIN:
-                                ledDataP->aCycle = LED_CYCLE_MAX - tmpIx;
-                                break;
-                              default:
-                                // no action if state is one of NOTATTACHED, STATE_ON, STATE_OFF
-                                break;
-                            }
-                            SET_TP4;
-                        }
-                        CLR_TP4;
-                    } else { 
-                       // End of ON-time not yet reached, compute next necessary step
-                       CLR_TP3;
-                       ledNextCyc = min( ledDataP->aCycle, ledNextCyc);
-                       SET_TP3;
+                    } else {
+                        // we are still in up/down
+                        ledDataP->aCycle = ledCycles( ledDataP, tmpIx );
                     }
+                    CLR_TP3;
                 }
-                //CLR_TP4;
             }
-            CLR_TP3;
-        }
+            if ( newCycle ) {
+                // event times are relative to the start of the PWM cycle
+                ledDataP->evtCyc = ledDataP->evtCyc > LED_CYCLE_MAX ? ledDataP->evtCyc - LED_CYCLE_MAX : 0;
+            }
+            if ( ledNextCyc > ledDataP->evtCyc ) ledNextCyc = ledDataP->evtCyc;
+            //CLR_TP1;
+        } // end of led loop
+        if ( newCycle ) ledCycleCnt = 0;
+        if ( ledNextCyc <= ledCycleCnt ) ledNextCyc = ledCycleCnt + 1;  // edge is due with the next IRQ
+        ledPortsWrite();
         //CLR_TP3;
      } // end of softleds 
     //CLR_TP3;
@@ -186,6 +220,92 @@ void softledISR(uintx8_t cyclesLastIRQ) { // uint8 for AVR, uint32 for 32-Bit pr
     //SET_TP3;
     CLR_TP2;
 } //=============================== End of softledISR ========================================
+#else // SOFTLED_BAM
+#ifndef FAST_PORTWRT
+#error "SOFTLED_BAM needs direct port access"
+#endif
+static uint8_t bamPlane = 0;        // actual bit plane
+
+static inline void bamSetDuty( ledData_t *ledP, uint8_t cycles ) {
+    // set the bits of the led in the bit planes of its port. 'cycles' is the 
+    // pulselength in IRQ cycles ( 0...LED_CYCLE_MAX ), converted to 0...BAM_CYCLE
+    uint8_t duty = ( cycles * ( ( BAM_CYCLE * 256 + LED_CYCLE_MAX - 1 ) / LED_CYCLE_MAX ) + 128 ) >> 8;
+    if ( duty > BAM_CYCLE ) duty = BAM_CYCLE;
+    if ( ledP->invFlg ) duty = ~duty;
+    uint8_t mask = ledP->portPin.Mask;
+    uint8_t *planeP = ledP->ledPortP->plane;
+    for ( uint8_t n = 0; n < BAM_BITS; n++ ) {
+        if ( duty & 1 ) planeP[n] |= mask;
+        else planeP[n] &= ~mask;
+        duty >>= 1;
+    }
+}
+
+static inline void bamRemove( ledData_t *ledP, LedStats_t state ) {
+    // led reached its steady state, remove from active-chain
+    ledP->state = state;
+    *ledP->backLedDataPP = ledP->nextLedDataP;
+    if ( ledP->nextLedDataP ) ledP->nextLedDataP->backLedDataPP = ledP->backLedDataPP;
+}
+
+static inline void bamStep( ledData_t *ledP ) {
+    // set the pulselength for this PWM cycle and compute the pulselength of the next cycle
+    uint8_t tmpIx;
+    bamSetDuty( ledP, ledP->aCycle );
+    if ( ( ledP->state == INCBULB || ledP->state == INCLIN || ledP->state == INCGAMMA )
+         && ledP->aCycle >= LED_CYCLE_MAX ) {
+        // led is full on
+        bamRemove( ledP, STATE_ON );
+        ledP->aCycle = 0;
+        return;
+    }
+    ledP->aStep += ledP->speed;
+    tmpIx = (ledP->aStep/DELTASTEPS);
+    if ( tmpIx > LED_IX_MAX ) {
+        // the end is reached
+        if ( ledP->state == DECBULB || ledP->state == DECLIN || ledP->state == DECGAMMA ) {
+            bamSetDuty( ledP, 0 );
+            bamRemove( ledP, STATE_OFF );
+        } else {
+            // switch permanently on with next cycle
+            ledP->aCycle = LED_CYCLE_MAX;
+        }
+    } else {
+        ledP->aCycle = ledCycles( ledP, tmpIx );
+    }
+}
+
+void softledISR(uintx8_t cyclesLastIRQ) {
+    // ---------------------- softleds with bit angle modulation ---------------------
+    // There are always BAM_BITS IRQs per PWM cycle, the time until the next IRQ doubles with
+    // every bit plane. Only leds with rising/falling brightness are computed, at start of the PWM cycle.
+    SET_TP2;
+    ledCycleCnt += cyclesLastIRQ;
+    if ( ledCycleCnt >= ledNextCyc ) {
+        TRACE_EVENT( TR_SOFTLED, 0, ledCycleCnt );
+        if ( ledCycleCnt >= BAM_CYCLE ) {
+            // start of a new PWM cycle
+            ledCycleCnt = 0;
+            bamPlane = 0;
+            if ( lastEffectP != NULL ) ledEffectTick();
+            for ( ledDataP=ledRootP; ledDataP!=NULL; ledDataP = ledDataP->nextLedDataP ) {
+                bamStep( ledDataP );
+            }
+        } else {
+            bamPlane++;
+        }
+        // output the bit plane
+        for ( ledPort_t *portP = ledPortRootP; portP != NULL; portP = portP->nextPortP ) {
+            noInterrupts(); // the servo IRQ writes to the ports too
+            *portP->adr = ( *portP->adr & ~portP->mask ) | portP->plane[bamPlane];
+            interrupts();
+        }
+        ledNextCyc = ( 2 << bamPlane ) - 1;   // end of this bit plane
+    }
+    nextCycle = min( nextCycle, ( ledNextCyc-ledCycleCnt ) );
+    CLR_TP2;
+} //=============================== End of softledISR ( BAM ) =================================
+#endif // SOFTLED_BAM
 /////////////////////////////////////////////////////////////////////////////
 //Class MoToMoToSoftLed - for Led with soft on / soft off ---------------------------
 // Version with Software PWM
@@ -199,13 +319,23 @@ MoToSoftLed::MoToSoftLed() {
     _ledType = LINEAR;
     _ledData.nextLedDataP = NULL;    // don't put in ISR chain
     _ledData.invFlg = false;
+    #ifdef FAST_PORTWRT
+    _ledData.ledPortP = NULL;
+    _ledPort.ledCnt = 0;
+    #endif
+    #ifndef SOFTLED_BAM
+    _ledData.phase    = 0;
+    _ledData.evtCyc   = 0;
+    #endif
 }
 
 void MoToSoftLed::mount( LedStats_t stateVal ) {
     // mount softLed to ISR chain ( if not already in )
     // new active Softleds are always inserted at the beginning of the chain
     // only leds in the ISR chain are processed in ISR
-    noInterrupts();
+    // may be called from the softled ISR too ( MoToLedEffect )
+    uint8_t oldSREG = SREG;
+    cli();
     //SET_TP2;
     // check if it's not already active (mounted)
     // Leds must not be mounted twice!
@@ -217,34 +347,121 @@ void MoToSoftLed::mount( LedStats_t stateVal ) {
         _ledData.nextLedDataP = ledRootP;
         ledRootP = &_ledData;
         _ledData.backLedDataPP = &ledRootP;
+        #ifndef SOFTLED_BAM
+        // the first pulse starts at the phase of the led in the next PWM cycle. An earlier start in this
+        // cycle would not be met: the next IRQ may already be set to a later cycle ( ledNextCyc )
+        _ledData.actPulse = false;
+        _ledData.evtCyc = _ledData.phase + LED_CYCLE_MAX;
+        #endif
         //SET_TP2;
     }
     _ledData.state = stateVal;
     //CLR_TP2;
-    interrupts();
+    SREG = oldSREG;
 }   
     
+#ifdef FAST_PORTWRT
+static ledPort_t* findLedPort( volatile uint8_t *adr ) {
+    ledPort_t *portP = ledPortRootP;
+    while ( portP != NULL && portP->adr != adr ) portP = portP->nextPortP;
+    return portP;
+}
+
+static void releaseLedPort( ledData_t *ledP ) {
+    // the led leaves its port ( re-attach to another pin ). Its pin is switched off and a port
+    // record without leds is removed from the chain. Must be called with interrupts disabled
+    ledPort_t *portP = ledP->ledPortP;
+    uint8_t mask = ledP->portPin.Mask;
+    #ifdef SOFTLED_BAM
+    portP->mask &= ~mask;
+    for ( uint8_t n = 0; n < BAM_BITS; n++ ) portP->plane[n] &= ~mask;
+    #else
+    portP->setMask &= ~mask;
+    portP->clrMask &= ~mask;
+    #endif
+    if ( ledP->invFlg ) *portP->adr |= mask;
+    else                *portP->adr &= ~mask;
+    if ( --portP->ledCnt == 0 ) {
+        ledPort_t **portPP = &ledPortRootP;
+        while ( *portPP != portP ) portPP = &(*portPP)->nextPortP;
+        *portPP = portP->nextPortP;
+    }
+    ledP->ledPortP = NULL;
+}
+#endif
+
 uint8_t MoToSoftLed::attach(uint8_t pinArg, uint8_t invArg ){
     // Led-Ausgang mit Softstart. 
     
+    #ifdef FAST_PORTWRT
+    volatile uint8_t *portAdr = portOutputRegister(digitalPinToPort(pinArg));
+    uint8_t portMask = digitalPinToBitMask(pinArg);
+    noInterrupts();     // the led may be active in the ISR, its port must always be valid
+    if ( _ledData.ledPortP != NULL && ( _ledData.portPin.Adr != portAdr || _ledData.portPin.Mask != portMask ) ) {
+        // re-attach to another pin: leave the old port first. If there is no record for the new port
+        // yet, the own record is needed, but it must not be used by other leds of the old port anymore
+        if ( findLedPort( portAdr ) == NULL
+             && _ledPort.ledCnt > ( _ledData.ledPortP == &_ledPort ? 1 : 0 ) ) {
+            interrupts();
+            return false;
+        }
+        releaseLedPort( &_ledData );
+    }
+    #else
+    noInterrupts();
+    #endif
+    if ( _ledData.state >= ACTIVE ) {
+        // re-attach while fading: remove the led from the ISR chain, it starts with OFF
+        *_ledData.backLedDataPP = _ledData.nextLedDataP;
+        if ( _ledData.nextLedDataP ) _ledData.nextLedDataP->backLedDataPP = _ledData.backLedDataPP;
+    }
+    _ledData.state   = STATE_OFF ;   // initialize 
+    _setpoint = OFF;
     _ledData.invFlg  = invArg;
+    #ifdef FAST_PORTWRT
+    if ( _ledData.ledPortP == NULL ) {
+        // look for the port record of this port, or use the record of this led for a new port
+        _ledData.portPin.Adr = portAdr;
+        _ledData.portPin.Mask = portMask;
+        ledPort_t *portP = findLedPort( portAdr );
+        if ( portP == NULL ) {
+            portP = &_ledPort;
+            portP->adr = portAdr;
+            #ifdef SOFTLED_BAM
+            portP->mask = 0;
+            for ( uint8_t n = 0; n < BAM_BITS; n++ ) portP->plane[n] = 0;
+            #else
+            portP->setMask = 0;
+            portP->clrMask = 0;
+            #endif
+            portP->nextPortP = ledPortRootP;
+            ledPortRootP = portP;
+        }
+        portP->ledCnt++;
+        _ledData.ledPortP = portP;
+        #ifdef SOFTLED_BAM
+        bamSetDuty( &_ledData, 0 );     // led is off
+        portP->mask |= _ledData.portPin.Mask;
+        #endif
+    }
+    #else
+    _ledData.pin=pinArg ;      // Pin-Nbr 
+    #endif
+    interrupts();
     pinMode( pinArg, OUTPUT );
     //DB_PRINT( "Led attached, ledIx = 0x%x, Count = %d", ledIx, ledCount );
-    _ledData.state   = STATE_OFF ;   // initialize 
     riseTime( LED_DEFAULT_RISETIME );
+    #ifndef SOFTLED_BAM
+    // stagger the pulses of the leds over the PWM cycle
+    _ledData.phase = ledPhaseNext;
+    ledPhaseNext = ( ledPhaseNext + LED_PHASE_STEP ) % LED_CYCLE_MAX;
+    #endif
     if ( _ledData.invFlg ) { 
         digitalWrite( pinArg, HIGH );
     } else {
         digitalWrite( pinArg, LOW );
     }
     
-    #ifdef FAST_PORTWRT
-    _ledData.portPin.Adr = portOutputRegister(digitalPinToPort(pinArg));
-    _ledData.portPin.Mask = digitalPinToBitMask(pinArg);
-    #else
-    _ledData.pin=pinArg ;      // Pin-Nbr 
-    #endif
-    
     seizeTimerAS();
     // enable compareB- interrupt
     #if defined(__AVR_ATmega8__)|| defined(__AVR_ATmega128__)
@@ -274,10 +491,16 @@ void MoToSoftLed::on(){
         if ( _ledType == LINEAR ) {
             stateT          = INCLIN;
             _ledData.aCycle  = 1;
+        } else if ( _ledType == GAMMA ) {
+            stateT          = INCGAMMA;
+            _ledData.aCycle  = 0;
         } else { // is bulb simulation
             stateT          = INCBULB;
             _ledData.aCycle  = iSteps[1];
         }
+        #ifdef SOFTLED_DITHER
+        _ledData.ditherErr = 0;
+        #endif
         mount(stateT);
     }
     DB_PRINT( "Led %04X On, state=%d, ledRoot=%04X", (uint32_t)this, _ledData.state, (uintxx_t)ledRootP);
@@ -301,12 +524,18 @@ void MoToSoftLed::off(){
         if ( _ledType == LINEAR ) {
             stateT          = DECLIN;
             _ledData.aCycle  = LED_IX_MAX;
+        } else if ( _ledType == GAMMA ) {
+            stateT          = DECGAMMA;
+            _ledData.aCycle  = LED_CYCLE_MAX-1;
         } else { // is bulb simulation
             //CLR_TP3;
             stateT = DECBULB;
             _ledData.aCycle = LED_CYCLE_MAX  - iSteps[1];
         }
         //CLR_TP3;
+        #ifdef SOFTLED_DITHER
+        _ledData.ditherErr = 0;
+        #endif
         mount(stateT);
     }
     DB_PRINT( "Led %04X Off, state=%d", (uint32_t)this, _ledData.state);
@@ -344,7 +573,7 @@ void MoToSoftLed::riseTime( uint16_t riseTime ) {
     // with speed value = 16 means risetime is (LED_CYCLE_MAX * LED_PWMTIME * DELTATIME / 16)
     // risetime = (LED_CYCLE_MAX * LED_PWMTIME * DELTATIME) / speed
     // 
-    long riseMax = ((long) LED_CYCLE_MAX * DELTASTEPS * LED_PWMTIME );
+    long riseMax = ((long) LED_CYCLE_MAX * DELTASTEPS * LED_FRAMETIME / 1000 );
     if ( riseTime <= 20 ) riseTime = 20;
     if ( riseTime >= riseMax/16 ) riseTime = riseMax/16;
     int tmp = ( ((long)riseMax  *10) / ( riseTime  ) +5 ) /10;
@@ -366,4 +595,74 @@ void MoToSoftLed::off(uint8_t value){
 #pragma GCC diagnostic pop
 
 
+///////////////////////////////////////////////////////////////////////////////////
+// --------- Class MoToLedEffect ---------------------------------
+MoToLedEffect::MoToLedEffect( MoToSoftLed *leds[], uint8_t count, const ledStep_t *steps ) {
+    _leds = leds;
+    _count = count > 16 ? 16 : count;   // the pattern has 16 bits
+    _steps = steps;
+    _stepIx = 0;
+    _waitCnt = 0;
+    _running = false;
+    _loop = true;
+    noInterrupts();
+    _prevEffP = lastEffectP;
+    lastEffectP = this;
+    interrupts();
+}
+
+void MoToLedEffect::play( bool loop ) {
+    // the first step is started at the next PWM cycle
+    noInterrupts();
+    _stepIx = 0;
+    _waitCnt = 0;
+    _loop = loop;
+    _running = true;
+    interrupts();
+}
+
+void MoToLedEffect::stop() {
+    _running = false;
+}
+
+bool MoToLedEffect::playing() {
+    return _running;
+}
+
+uint16_t MoToLedEffect::step() {
+    noInterrupts();
+    uint16_t stepIx = _stepIx;
+    interrupts();
+    return stepIx;
+}
+
+void MoToLedEffect::_tick() {
+    // runs in the softled IRQ at the start of a PWM cycle.
+    // Switch the leds according to the pattern of the next step, if it is due
+    if ( _waitCnt > 0 ) {
+        _waitCnt--;
+        return;
+    }
+    const ledStep_t *stepP = &_steps[_stepIx];
+    uint16_t cycles = pgm_read_word( &stepP->cycles );
+    if ( cycles == 0 ) {
+        // end of the effect
+        stepP = _steps;
+        cycles = pgm_read_word( &stepP->cycles );
+        if ( !_loop || cycles == 0 ) {
+            _running = false;
+            return;
+        }
+        _stepIx = 0;
+    }
+    uint16_t pattern = pgm_read_word( &stepP->pattern );
+    for ( uint8_t ledIx = 0; ledIx < _count; ledIx++ ) {
+        // on() and off() do nothing, if the led is already switched that way
+        if ( pattern & 1 ) _leds[ledIx]->on();
+        else _leds[ledIx]->off();
+        pattern >>= 1;
+    }
+    _stepIx++;
+    _waitCnt = cycles - 1;  // this cycle is the first one
+}
 #endif // ARDUINO_ARCH_AVR
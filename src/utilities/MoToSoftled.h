@@ -9,6 +9,12 @@
 */
 // defines for soft-leds
 #define MAX_LEDS    16     // Soft On/Off defined for compatibility reasons. There is no fixed limit anymore.
+#if defined SOFTLED_BAM && defined IS_32BIT
+#undef SOFTLED_BAM          // bit angle modulation is only available on 8-bit processors
+#endif
+#if defined SOFTLED_DITHER && !( defined ARDUINO_ARCH_AVR || defined ARDUINO_ARCH_MEGAAVR )
+#undef SOFTLED_DITHER       // dithering is only available on 8-bit processors
+#endif
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
@@ -31,16 +37,52 @@
                               60,61,62,63,64,65,65,66,66,67,67,68,68,69,69,70,70,71,71,72,
                               72,73,73,74,74,75,75,76,76,77,77,77,78,78,78,78,79,79,79 };
 
+    // gamma curve ( gamma 2.2 ) for perceptually even fading in 1/16 cycles, generated by
+    // gammaSteps[i] = round( 16*LED_CYCLE_MAX * (i/LED_CYCLE_MAX)^2.2 )
+    const uint16_t gammaSteps[] PROGMEM = {    0,   0,   0,   1,   2,   3,   4,   6,   8,  10,
+                                 13,  16,  20,  24,  28,  32,  37,  42,  48,  54,  61,  67,  75,  82,  91,
+                                 99, 108, 117, 127, 137, 148, 159, 171, 182, 195, 208, 221, 235, 249, 263,
+                                279, 294, 310, 327, 344, 361, 379, 397, 416, 435, 455, 475, 496, 517, 539,
+                                561, 584, 607, 631, 655, 680, 705, 731, 757, 783, 811, 838, 867, 895, 924,
+                                954, 984,1015,1046,1078,1111,1143,1177,1211,1245,1280 };
+    #define DITHERSTEPS 16  // with SOFTLED_DITHER the pulselength is computed in 1/16 cycles
+
     #define DELTASTEPS 128  // this MUST be a power of 2
     #define LED_IX_MAX    ((int16_t)sizeof(iSteps) -1) // int16_t to suppress warnings when comparing to aCycle
     #define LED_STEP_MAX    (LED_IX_MAX*DELTASTEPS)     // max value of ledData.aStep
     #define LED_CYCLE_MAX   (iSteps[0])
     #define LED_PWMTIME     LED_CYCLE_MAX * CYCLETIME / 1000  // PWM refreshrate in ms
+    #define LED_PHASE_STEP  31  // phase offset of consecutive attached leds ( IRQ cycles, no divisor of LED_CYCLE_MAX )
     
+    #ifdef SOFTLED_BAM
+    // bit angle modulation: bit plane n lasts 2^n IRQ cycles. All leds of a port are written
+    // together at the start of every bit plane
+    #define BAM_BITS        6                       // nbr of bit planes ( = IRQs per PWM cycle )
+    #define BAM_CYCLE       ( (1<<BAM_BITS) - 1 )   // PWM cycle in IRQ cycles
+    #define LED_FRAMETIME   ( BAM_CYCLE * CYCLETIME )   // PWM cycle in µs
+    #else
+    #define LED_FRAMETIME   ( LED_CYCLE_MAX * CYCLETIME )   // PWM cycle in µs
+    #endif
     
+    #ifdef FAST_PORTWRT
+    // the leds are grouped by ports, so every port is written only once in an ISR pass
+    typedef struct ledPort_t {      // all softleds of one port
+        struct ledPort_t* nextPortP;    // chain of ports
+        volatile uint8_t* adr;          // port address
+        uint8_t ledCnt;                 // nbr of leds using this record ( 0: not in chain )
+        #ifdef SOFTLED_BAM
+        uint8_t mask;                   // bits of the leds in this port
+        uint8_t plane[BAM_BITS];        // port bits of the leds for every bit plane
+        #else
+        uint8_t setMask;                // bits to be set at the end of the ISR pass
+        uint8_t clrMask;                // bits to be cleared at the end of the ISR pass
+        #endif
+    } ledPort_t;
+    #endif
 #endif
                                         
-enum LedStats_t:byte { NOTATTACHED, STATE_OFF, STATE_ON, ACTIVE, INCBULB, DECBULB, INCLIN, DECLIN, STOPPING };
+enum LedStats_t:byte { NOTATTACHED, STATE_OFF, STATE_ON, ACTIVE, INCBULB, DECBULB, INCLIN, DECLIN, STOPPING,
+                       INCGAMMA, DECGAMMA };
                         // values >= ACTIVE means active in ISR routine ( pulses are generated )
                         
 typedef struct ledData_t {          // global led values ( used in IRQ )
@@ -55,11 +97,17 @@ typedef struct ledData_t {          // global led values ( used in IRQ )
       uint16_t tPwmOff;                 // target PWM value (µs )
       uint16_t stepI;                   // actual step during rising/falling   
       uint16_t stepMax;                 // max nbr of steps between ON/OFF  ( determines rising/falling time )
+    #ifdef IS_ESP
       //computing of bulb-simulation (hyperbolic ramp): 
       // this values must be recomputed if tPwmon, tPwmoff changes
       // formula: pwm = hypPo + hypB/(stepOfs+(stepRef-stepI))
       int hypB;
       int hypPo;
+    #else
+      // bulb-simulation with the precomputed ramp table ( MoToSoftled32.cpp ):
+      // stepScale = RAMP_STEPS/stepMax as 16.16 fixpoint value, must be recomputed if stepMax changes
+      uint32_t stepScale;
+    #endif
       int8_t pwmNbr;                    // Number of leds HW ( ESP32 ), same as pin otherwise
   #else
       int16_t speed;                    // > 0 : steps per cycle switching on
@@ -67,6 +115,16 @@ typedef struct ledData_t {          // global led values ( used in IRQ )
                                         // 0: led is inactive (not attached)
       int16_t   aStep;                  // actual step between on/off or off/on ( always counts up )
       int8_t    aCycle;                 // actual cycle ( =length of PWM pule )
+      #ifndef SOFTLED_BAM
+      uint8_t   phase;                  // start of the pulse within the PWM cycle ( IRQ cycles )
+      uint8_t   evtCyc;                 // IRQ cycle of the next edge of the pulse
+      #endif
+      #ifdef SOFTLED_DITHER
+      uint8_t   ditherErr;              // remainder of the pulselength in 1/16 cycles ( sigma-delta )
+      #endif
+      #ifdef FAST_PORTWRT
+      ledPort_t* ledPortP;              // port of the led
+      #endif
   #endif
   LedStats_t state;	                // actual state: steady or incementing/decrementing
     
@@ -101,9 +159,12 @@ class MoToSoftLed
     void write( uint8_t time, uint8_t type  ); //whether it is a linear or bulb type
     void toggle( void ); 
   private:
-    void _computeBulbValues();    // used only with ESP8266
+    void _computeBulbValues();    // used only on 32-bit processors
     void mount( LedStats_t state );
     ledData_t _ledData;
+    #if defined FAST_PORTWRT && !defined IS_32BIT
+    ledPort_t _ledPort;      // used, if this is the first led of its port
+    #endif
     uint8_t	_setpoint;
     #define OFF 0
     #define ON  1
@@ -111,9 +172,52 @@ class MoToSoftLed
     uint8_t _ledType;        // Type of lamp (linear or bulb)
     #define LINEAR  0
     #define BULB    1
+    #define GAMMA   2       // perceptually even fading ( AVR only, on other platforms same as BULB )
     int16_t _ledSpeed;       // speed with IRQ based softleds
     
 };
 
 
+#ifndef IS_32BIT
+////////////////////////////////////////////////////////////////////////////////////////
+// light effects for a group of softleds, stored in flash and played in the softled IRQ ( AVR only )
+// Every step switches the leds of the group according to a bit pattern ( bit 0 = first led ).
+// The leds fade with their own riseTime.
+struct ledStep_t {
+  uint16_t pattern;     // bit n set: led n is switched on, max 16 leds
+  uint16_t cycles;      // PWM cycles until the next step ( computed by LED_STEP ), 0: end of effect
+};
+#define LED_MS2CYCLES(ms)   ( (uint32_t)(ms) * 1000 / LED_FRAMETIME )
+// step: switch the leds according to pattern, start the next step after timeMs
+#define LED_STEP( pattern, timeMs ) \
+        { pattern, (uint16_t)( LED_MS2CYCLES(timeMs) > 0 ? LED_MS2CYCLES(timeMs) : 1 ) }
+#define LED_EFFECTEND   { 0, 0 }
+
+class MoToLedEffect
+{
+  private:
+    MoToSoftLed **_leds;                // array of softleds ( provided by the sketch )
+    uint8_t _count;                     // number of leds
+    const ledStep_t *_steps;            // steps in PROGMEM, terminated by LED_EFFECTEND
+    volatile uint16_t _stepIx;          // next step
+    volatile uint16_t _waitCnt;         // PWM cycles until next step
+    volatile bool _running;
+    bool _loop;                         // restart at the end of the effect
+    MoToLedEffect *_prevEffP;           // chain of effects ( used in IRQ )
+    void _tick();                       // called in IRQ at the start of every PWM cycle
+    friend void ledEffectTick();
+    
+  public:
+    // don't allow copying and moving of effect objects
+    MoToLedEffect &operator= (const MoToLedEffect & )   =delete;
+    MoToLedEffect (const MoToLedEffect & )              =delete;
+
+    MoToLedEffect( MoToSoftLed *leds[], uint8_t count, const ledStep_t *steps );
+    void play( bool loop = true );      // start the effect from the beginning
+    void stop();                        // stop the effect ( the leds stay as they are )
+    bool playing();                     // true while the effect is running
+    uint16_t step();                    // index of the next step
+};
+#endif
+
 #endif
\ No newline at end of file
@@ -24,12 +24,34 @@ static int32_t ledCycleCnt = 0;    // count IRQ cycles within PWM cycle
 
 static ledData_t*  ledDataP;              // pointer to active Led in ISR
 
+// precomputed bulb ramp ( hyperbolic ): pwm = pwmOff + (pwmOn-pwmOff) * bulbRamp[ix] / 32768
+// bulbRamp[ix] = 32768 * ( (stepRef+stepOfs)*stepOfs/stepRef / (stepOfs+stepRef - stepRef*ix/RAMP_STEPS) - stepOfs/stepRef )
+#define RAMP_BITS   6
+#define RAMP_STEPS  (1<<RAMP_BITS)
+static const uint16_t bulbRamp[RAMP_STEPS+1] = {
+        0,    86,   175,   266,   360,   456,   555,   657,   762,   870,   981,  1096,  1214,
+     1335,  1461,  1591,  1725,  1863,  2006,  2154,  2308,  2466,  2631,  2802,  2979,  3163,
+     3354,  3553,  3760,  3976,  4201,  4436,  4681,  4938,  5206,  5487,  5783,  6093,  6418,
+     6762,  7123,  7506,  7910,  8337,  8791,  9274,  9788, 10336, 10923, 11551, 12227, 12955,
+    13741, 14594, 15522, 16534, 17644, 18866, 20219, 21723, 23406, 25302, 27454, 29919, 32768 };
+
+static inline uint32_t rampValue( ledData_t *ledP, int rampType ) {
+    // position within the ramp ( 0 ... 32768 ) for the actual step, no divisions needed
+    uint32_t pos = ledP->stepI * ledP->stepScale;  // table index as 16.16 fixpoint value
+    if ( rampType == LINEAR ) return pos >> ( 16 + RAMP_BITS - 15 );
+    uint32_t ix = pos >> 16;
+    if ( ix >= RAMP_STEPS ) return bulbRamp[RAMP_STEPS];
+    int32_t delta = bulbRamp[ix+1] - bulbRamp[ix];
+    return bulbRamp[ix] + ( ( delta * (int32_t)( pos & 0xffff ) ) >> 16 );
+}
+
 void softledISR(uint32_t cyclesLastIRQ) { // uint32 for 32-Bit processors
     // ---------------------- softleds -----------------------------------------------
     SET_TP4;
     ledCycleCnt += cyclesLastIRQ;
     if ( ledCycleCnt >= ledNextCyc ) {
         // this IRQ is relevant for softleds
+        TRACE_EVENT( TR_SOFTLED, 0, ledCycleCnt );
         ledNextCyc = PWMCYC; // there must be atleast one IRQ per PWM Cycle
         if ( ledCycleCnt >= PWMCYC ) {
             // start of a new PWM Cycle - switch all leds with rising/falling or active state to on
@@ -107,9 +129,10 @@ void softledISR(uint32_t cyclesLastIRQ) { // uint32 for 32-Bit processors
                     uint16_t pOff = max( MIN_PULSE, ledDataP->tPwmOff );
                     uint16_t pOn = min ( MAX_PULSE, ledDataP->tPwmOn );
                     if ( changePulse == LINEAR ) {
-                        ledDataP->aPwm = pOff + ( (pOn - pOff) * ledDataP->stepI / ledDataP->stepMax );
+                        ledDataP->aPwm = pOff + ( ( (pOn - pOff) * rampValue( ledDataP, LINEAR ) ) >> 15 );
                     } else {
-                        ledDataP->aPwm = ledDataP->hypPo + ledDataP->hypB/(stepOfs+stepRef - (stepRef * ledDataP->stepI / ledDataP->stepMax) );
+                        ledDataP->aPwm = ledDataP->tPwmOff + 
+                                ( ( ( ledDataP->tPwmOn - ledDataP->tPwmOff ) * rampValue( ledDataP, BULB ) ) >> 15 );
                     }
                 }  
                 if ( ledDataP->aPwm > 0 && ledNextCyc > ledDataP->aPwm ) ledNextCyc = ledDataP->aPwm; 
@@ -146,33 +169,12 @@ void softledISR(uint32_t cyclesLastIRQ) { // uint32 for 32-Bit processors
 // Version with Software PWM
 
 void MoToSoftLed::_computeBulbValues() {
-     // recompute parameter for bulb simulation ( hyperbolic approximation of pwm ramp )
-    int hypB;
-    int hypPo;
-    //hypB = ( _ledData.tPwmOn - _ledData.tPwmOff )*_ledData.stepOfs*(_ledData.hypF*_ledData.stepRef+_ledData.stepOfs)/(_ledData.hypF*_ledData.stepRef);
-    //hypPo = _ledData.tPwmOn - hypB/_ledData.stepOfs;
-    hypB = (stepOfs*(stepRef+stepOfs)/(stepRef)) * ( _ledData.tPwmOn - _ledData.tPwmOff );
-    //hypPo = _ledData.tPwmOn - hypB/stepOfs;
-    hypPo = _ledData.tPwmOff - hypB/(stepOfs+stepRef);
+    // recompute the scaling of the steps to the precomputed ramp
+    // this must be recomputed if stepMax changes
+    uint32_t stepScale = ( (uint32_t)RAMP_STEPS << 16 ) / _ledData.stepMax;
     noInterrupts();
-    _ledData.hypPo = hypPo;
-    _ledData.hypB = hypB;
+    _ledData.stepScale = stepScale;
     interrupts();
-    #if 0 //def debugPrint
-    // print pwmval for step= 0, step=max/2, step=max
-    int pwmOff = hypPo + hypB/(stepOfs+(stepRef - 0 ));
-    int pwm2 = hypPo + hypB/(stepOfs+(stepRef/2 ));
-    int pwmOn = hypPo + hypB/(stepOfs);
-    DB_PRINT("Hyperbolic ramp ( pwmOff=%d, pwmOn=%d, stepRef=%d  .. B=%d, Po=%d", _ledData.tPwmOff,_ledData.tPwmOn,stepRef, hypB, hypPo);
-    DB_PRINT("Pwm-0=%d,  Pwm1/2=%d, PwmMax=%d", pwmOff, pwm2, pwmOn);
-    for( byte ix=0; ix<=20; ix++ ) {
-        SET_TP2;CLR_TP2;SET_TP2;
-        int step = stepRef * ix / 20;
-        int pwm = hypPo + hypB/(stepOfs+stepRef - step );
-        CLR_TP2;
-        DB_PRINT(" Step %5d - pwm = %6d", step, pwm );
-    }
-    #endif
 }
 
 void MoToSoftLed::mount( LedStats_t stateVal ) {
@@ -205,6 +207,7 @@ MoToSoftLed::MoToSoftLed() {
     _ledData.tPwmOff  = 0;           // target PWM value (µs )
     _ledData.stepI    = 0;           // start of rising
     _ledData.stepMax  = LED_DEFAULT_RISETIME*1000/PWMCYC; // total steps for rising/falling ramp
+    _ledData.stepScale = ( (uint32_t)RAMP_STEPS << 16 ) / _ledData.stepMax;
     _ledData.state    = NOTATTACHED; // initialize 
     _setpoint = OFF ;                // initialize to off
     _ledType = LINEAR;
@@ -338,11 +341,11 @@ void MoToSoftLed::riseTime( uint16_t riseTime ) {
     _ledSpeed = riseTime;
     stepMax = riseTime * 1000L / PWMCYC; // Nbr of pwm steps from ON to OFF and vice versa
     // adjust stepnumbers for ISR
-    _computeBulbValues();
     noInterrupts();
     _ledData.stepI = (long)_ledData.stepI * stepMax / _ledData.stepMax; // adjust actual position to new risetime
     _ledData.stepMax = stepMax;
     interrupts();
+    _computeBulbValues();
     DB_PRINT( "_ledSpeed = %d ( risetime=%d ), StepMax=%d", _ledSpeed, riseTime, stepMax );
 }
 
@@ -0,0 +1,129 @@
+/*
+  MobaTools.h - a library for model railroaders
+  Author: fpm, fpm@mnet-mail.de
+  Copyright (c) 2020 All right reserved.
+
+  Functions for the timing statistics of MobaTools
+*/
+#include <MobaTools.h>
+#include <utilities/MoToDbg.h>
+
+#ifdef MOTO_STATS
+isrStats_t isrStats;    // written in the stepper/softled IRQ of the platform
+#endif
+
+uint16_t MoToStats::isrOverruns() {
+    uint16_t tmp = 0;
+    #ifdef MOTO_STATS
+    _noStepIRQ();
+    tmp = isrStats.isrOverruns;
+    _stepIRQ();
+    #endif
+    return tmp;
+}
+
+uint16_t MoToStats::maxIsrTics() {
+    uint16_t tmp = 0;
+    #ifdef MOTO_STATS
+    _noStepIRQ();
+    tmp = isrStats.maxIsrTics;
+    _stepIRQ();
+    #endif
+    return tmp;
+}
+
+uint16_t MoToStats::lateSteps( MoToStepper &stepper ) {
+    uint16_t tmp = 0;
+    #if defined MOTO_STATS && !defined ESP8266
+    _noStepIRQ();
+    tmp = stepper._stepperData.lateSteps;
+    _stepIRQ();
+    #else
+    (void)stepper;
+    #endif
+    return tmp;
+}
+
+uint16_t MoToStats::maxLateTics( MoToStepper &stepper ) {
+    uint16_t tmp = 0;
+    #if defined MOTO_STATS && !defined ESP8266
+    _noStepIRQ();
+    tmp = stepper._stepperData.maxLateTics;
+    _stepIRQ();
+    #else
+    (void)stepper;
+    #endif
+    return tmp;
+}
+
+int16_t MoToStats::minPulseErr( MoToServo &servo ) {
+    int16_t tmp = 0;
+    #if defined MOTO_STATS && !defined IS_ESP
+    noInterrupts();
+    if ( servo._servoData.maxPulseErr >= servo._servoData.minPulseErr ) tmp = servo._servoData.minPulseErr;
+    interrupts();
+    #else
+    (void)servo;
+    #endif
+    return tmp;
+}
+
+int16_t MoToStats::maxPulseErr( MoToServo &servo ) {
+    int16_t tmp = 0;
+    #if defined MOTO_STATS && !defined IS_ESP
+    noInterrupts();
+    if ( servo._servoData.maxPulseErr >= servo._servoData.minPulseErr ) tmp = servo._servoData.maxPulseErr;
+    interrupts();
+    #else
+    (void)servo;
+    #endif
+    return tmp;
+}
+
+uint16_t MoToStats::badPulses( MoToServo &servo ) {
+    uint16_t tmp = 0;
+    #if defined MOTO_STATS && !defined IS_ESP
+    noInterrupts();
+    tmp = servo._servoData.badPulses;
+    interrupts();
+    #else
+    (void)servo;
+    #endif
+    return tmp;
+}
+
+void MoToStats::reset() {
+    #ifdef MOTO_STATS
+    _noStepIRQ();
+    isrStats.isrOverruns = 0;
+    isrStats.maxIsrTics = 0;
+    _stepIRQ();
+    #endif
+}
+
+void MoToStats::reset( MoToStepper &stepper ) {
+    #if defined MOTO_STATS && !defined ESP8266
+    _noStepIRQ();
+    stepper._stepperData.lateSteps = 0;
+    stepper._stepperData.maxLateTics = 0;
+    _stepIRQ();
+    #else
+    (void)stepper;
+    #endif
+}
+
+void MoToStats::reset( MoToServo &servo ) {
+    #if defined MOTO_STATS && !defined IS_ESP
+    noInterrupts();
+    servo._servoData.minPulseErr = INT16_MAX;
+    servo._servoData.maxPulseErr = INT16_MIN;
+    servo._servoData.badPulses = 0;
+    interrupts();
+    #else
+    (void)servo;
+    #endif
+}
+
+uint32_t MoToStats::tics2micros( uint32_t tics ) {
+    return tics / TICS_PER_MICROSECOND;
+}
@@ -0,0 +1,31 @@
+#ifndef MOTOSTATS_H
+#define MOTOSTATS_H
+/*
+  MobaTools.h - a library for model railroaders
+  Author: fpm, fpm@mnet-mail.de
+  Copyright (c) 2020 All right reserved.
+
+  Definitions and declarations for the timing statistics of MobaTools
+  The values are only collected if MOTO_STATS is defined in MobaTools.h, otherwise all methods return 0.
+  The servo pulse statistics compare the real length of the servo pulses with the computed length ( not on ESP ).
+  All counters saturate at 65535, times are in timer tics ( use tics2micros() to convert to µs )
+*/
+
+class MoToStats
+{ // timing statistics of the stepper/softled and servo IRQ
+  public:
+    static uint16_t isrOverruns();          // nbr of IRQs that lasted longer than the time until the next IRQ
+    static uint16_t maxIsrTics();           // max time from compare match to the end of the IRQ
+    static uint16_t lateSteps( MoToStepper &stepper );    // nbr of steps that have been output later than scheduled
+    static uint16_t maxLateTics( MoToStepper &stepper );  // max delay of a step
+                                            // ( no step statistics on ESP8266 )
+    static int16_t minPulseErr( MoToServo &servo );  // min/max deviation of the servo pulse length
+    static int16_t maxPulseErr( MoToServo &servo );  // ( timer tics, 0 if no pulse was measured )
+    static uint16_t badPulses( MoToServo &servo );   // nbr of pulses with a deviation of more than 1µs
+    static void reset();                    // reset the IRQ statistics
+    static void reset( MoToStepper &stepper ); // reset the statistics of one stepper
+    static void reset( MoToServo &servo );  // reset the pulse statistics of one servo
+    static uint32_t tics2micros( uint32_t tics ); // convert timer tics to µs
+};
+
+#endif
@@ -36,6 +36,28 @@ byte MoToStepper::_stepperCount = 0;
 #include "utilities/MoToStepperNo8266.inc"
 #endif // esp8266 <-> other
 
+// division by an invariant divisor d ( Granlund/Montgomery ). The result is exact for all 32-bit dividends.
+// the divisor must be 0 < d < 2^31
+static void setRecip( recip_t &recip, uint32_t d ) {
+    uint8_t l = 0;      // l = ceil( log2(d) )
+    while ( l < 31 && ( 1UL << l ) < d ) l++;
+    // m = floor( 2^32 * (2^l - d) / d ) + 1, computed by long division ( (2^l - d) < d )
+    uint32_t rem = ( 1UL << l ) - d;
+    uint32_t m = 0;
+    for ( uint8_t i = 0; i < 32; i++ ) {
+        rem <<= 1; m <<= 1;
+        if ( rem >= d ) { rem -= d; m |= 1; }
+    }
+    recip.m = m + 1;
+    recip.sh1 = l > 0 ? 1 : 0;
+    recip.sh2 = l > 0 ? l - 1 : 0;
+}
+
+static inline uint32_t recipDiv( const recip_t &recip, uint32_t n ) {
+    uint32_t t1 = ( (uint64_t)n * recip.m ) >> 32;
+    return ( t1 + ( ( n - t1 ) >> recip.sh1 ) ) >> recip.sh2;
+}
+
 // constructor -------------------------
 MoToStepper::MoToStepper(long steps ) {
     // constuctor for stepper Class, initialize data
@@ -63,6 +85,9 @@ void MoToStepper::initialize ( long steps360, uint8_t mode ) {
     MODE_TP4;
     _stepperIx = _stepperCount ;
     stepsRev = steps360;       // number of steps for full rotation in fullstep mode
+    setRecip( _recipRev, stepsRev );
+    setRecip( _recipAngle, 360 );
+    _recipFact = 1;
     if ( mode != FULLSTEP && mode != STEPDIR ) mode = HALFSTEP;
     stepMode = mode;
     // initialize data for interrupts
@@ -80,6 +105,7 @@ void MoToStepper::initialize ( long steps360, uint8_t mode ) {
 	    _stepperData.tCycRemain = 0;                // work with remainder when cruising ( only 8-bit processors )
 	#endif
     _stepperData.stepsFromZero = 0;
+    _stepperData.endless = false;
     _stepperData.rampState = rampStat::INACTIVE;
     _stepperData.stepRampLen             = 0;               // initialize with no acceleration  
     _stepperData.delayActiv = false;            // enable delaytime is runnung ( only ESP)
@@ -87,6 +113,13 @@ void MoToStepper::initialize ( long steps360, uint8_t mode ) {
     _stepperData.enablePin = NO_STEPPER_ENABLE;             // without enable (default)
     _stepperData.nextStepperDataP = NULL;
 	#ifndef ESP8266
+    _stepperData.startHold = false;
+    _prepared = false;
+    _ssValid = false;
+    #ifdef MOTO_STATS
+    _stepperData.lateSteps = 0;
+    _stepperData.maxLateTics = 0;
+    #endif
     // add at end of chain
     stepperData_t **tmpPP = &stepperRootP;
     while ( *tmpPP != NULL ) tmpPP = &((*tmpPP)->nextStepperDataP);
@@ -97,12 +130,32 @@ void MoToStepper::initialize ( long steps360, uint8_t mode ) {
     }
     
 }
-long MoToStepper::getSFZ() {
+static long moveDistance( stepPos_t distance ) {
+    // distance of a move to an absolute position ( write, writeSteps ). With MOTO_POS64 the position
+    // may be far beyond the range of long ( e.g. after a long rotate() ). A single move is limited to
+    // MAXMOVE steps then, it goes in the right direction but stops early.
+    #ifdef MOTO_POS64
+    const stepPos_t MAXMOVE = 0x3fffffffL;  // leave room for the corrections in _doSteps
+    if ( distance > MAXMOVE ) return MAXMOVE;
+    if ( distance < -MAXMOVE ) return -MAXMOVE;
+    #endif
+    return (long)distance;
+}
+
+stepPos_t MoToStepper::getSFZ() {
     // get step-distance from zero point
+    #ifdef MOTO_POS64
+    // stepsFromZero is updated in interrupt. Instead of disabling the irq read it until two
+    // consecutive reads are identical ( the value cannot be torn then )
+    do {
+        lastSFZ = _stepperData.stepsFromZero;
+    } while ( lastSFZ != _stepperData.stepsFromZero );
+    #else
     // irq must be disabled, because stepsFromZero is updated in interrupt
     noInterrupts();
     lastSFZ = _stepperData.stepsFromZero;
     interrupts();
+    #endif
     //digitalWrite(16,1);
     // in STEPDIR mode there is no difference between half/fullstep in counting steps
     return ( stepMode==STEPDIR?lastSFZ:lastSFZ / stepMode);
@@ -206,6 +259,9 @@ uint8_t MoToStepper::attach( byte outArg, byte pins[] ) {
     if ( attachOK ) {
         _stepperData.output = outArg;
         _stepperData.rampState = rampStat::STOPPED;
+        #ifndef ESP8266
+        _ssValid = false;   // speed and ramp must be set even if unchanged
+        #endif
         setSpeedSteps( DEF_SPEEDSTEPS, DEF_RAMP );
         seizeTimerAS();
         enableStepperIsrAS();
@@ -281,6 +337,29 @@ void MoToStepper::attachEnable( uint16_t delay ) {
 	attachEnable( NO_ENABLEPIN, delay, true );
 	}
 }
+
+uint8_t MoToStepper::prepare() {
+    // The next move from standstill is set up as usual, but the ISR does not start it
+    // until it is released by startAll(). This allows starting several steppers with the same IRQ
+    if ( _stepperData.output == NO_OUTPUT || _chkRunning() ) return 0; // not attached or already moving
+    _prepared = true;
+    return 1<<_stepperIx;
+}
+
+void MoToStepper::startAll( uint8_t stepperMask ) {
+    // release all prepared steppers in stepperMask ( bit 0 is the first created stepper object ).
+    // The stepper IRQ is disabled while releasing, so all of them start with the same IRQ
+    uint8_t stepperBit = 1;
+    _noStepIRQ();
+    for ( stepperData_t *stepperDataP = stepperRootP; stepperDataP != NULL; stepperDataP = stepperDataP->nextStepperDataP ) {
+        if ( (stepperMask & stepperBit) && stepperDataP->startHold ) {
+            stepperDataP->cycCnt = 0;           // start with the next IRQ
+            stepperDataP->startHold = false;
+        }
+        stepperBit <<= 1;
+    }
+    _stepIRQ();
+}
 #endif
 
 void MoToStepper::attachEnable( uint8_t enablePin, uint16_t delay, bool active ) {
@@ -324,6 +403,10 @@ int MoToStepper::setSpeed( int rpm10 ) {
 uintxx_t MoToStepper::setSpeedSteps( uintxx_t speed10 ) {
     // Speed in steps per sec * 10
     // without a new ramplen, the ramplen is adjusted according to the speedchange
+    #ifndef ESP8266
+    if ( _ssValid && _ssRampLen < 0 && speed10 == _ssSpeed10 ) return _stepperData.stepRampLen; // nothing changed
+    if ( _retargetSpeed( speed10 ) ) return _stepperData.stepRampLen;   // moving: only the target speed changes
+    #endif
     speed10 = min( uintxx_t(1000000L / MIN_STEPTIME * 10), speed10 );
     #ifdef IS_32BIT
     long rtmp = (uint64_t)speed10*_lastRampLen/_lastRampSpeed;
@@ -355,14 +438,13 @@ int32_t MoToStepper::getSpeedSteps( ) {
     #else
         uint16_t actSpeedSteps = 0;
         // get actual values from ISR
-        uint16_t aCycSteps ;
-        uint16_t aCycRemain ;
         _noStepIRQ();
         uint16_t stepsInRamp = _stepperData.stepsInRamp;
         rampStat rampState = _stepperData.rampState;
         #ifdef debugPrint
-			aCycSteps = _stepperData.aCycSteps;
-			aCycRemain = _stepperData.aCycRemain;
+			// step values of the ISR for the debug output below
+			uint16_t aCycSteps = _stepperData.aCycSteps;
+			uint16_t aCycRemain = _stepperData.aCycRemain;
 			uint16_t tCycSteps = _stepperData.tCycSteps;
 			uint16_t tCycRemain = _stepperData.tCycRemain;
         #endif
@@ -372,13 +454,11 @@ int32_t MoToStepper::getSpeedSteps( ) {
             // stepper is moving with target speed
             actSpeedSteps = _stepSpeed10;
         } else if ( rampState > rampStat::STOPPED ) {
-            // we are in a ramp
-            aCycSteps = _stepperData.cyctXramplen / (stepsInRamp + RAMPOFFSET ) ;
-            aCycRemain = _stepperData.cyctXramplen % (stepsInRamp + RAMPOFFSET);
-
-            actSpeedSteps = 1000000L * 10 / ( (long)aCycSteps*CYCLETIME + (long)aCycRemain*CYCLETIME/(stepsInRamp + RAMPOFFSET ) );
+            // we are in a ramp: steplength is cyctXramplen/(stepsInRamp+RAMPOFFSET), so the speed
+            // is proportional to (stepsInRamp+RAMPOFFSET). The factor is precomputed in setSpeedSteps
+            actSpeedSteps = ( (uint32_t)(stepsInRamp + RAMPOFFSET) * _rampSpeedFactor ) >> 8;
         }
-        DB_PRINT( "Acyc=%5d, Arem=%5d, SiR=%d, ( Tcyc=%5d, Trem=%5d, Dir=%d ) ", aCycSteps, aCycRemain, stepsInRamp, tCycSteps, tCycRemain,direction );
+        DB_PRINT( "Spd=%5u, Acyc=%5d, Arem=%5d, SiR=%d, ( Tcyc=%5d, Trem=%5d, Dir=%d )", actSpeedSteps, aCycSteps, aCycRemain, stepsInRamp, tCycSteps, tCycRemain,direction );
     #endif
 	return (int32_t)actSpeedSteps * direction;
 }
@@ -403,6 +483,7 @@ void MoToStepper::_doSteps( long stepValue, bool absPos ) {
 	//SET_TP1;
     //Serial.print( "doSteps: " ); Serial.println( stepValue );
     stepsToMove = stepValue;
+    _stepperData.endless = false;   // rotate() sets it again after the move is started
     stepCnt = labs(stepValue); // abs() doesn't work correctly on Nano Every for type long !!??? -> labs() works!
 	DB_PRINT(">>>>>>>>>>doSteps(%ld,%ld)>>>>>>>>>>>>>>>", stepValue,stepCnt );
     
@@ -417,7 +498,7 @@ void MoToStepper::_doSteps( long stepValue, bool absPos ) {
                 _noStepIRQ();
                 //digitalWrite(16,0);
                 // When moving to abs position, adjust stepCnt if there have been new steps
-                if ( absPos ) stepCnt -= abs( _stepperData.stepsFromZero-lastSFZ );
+                if ( absPos ) stepCnt -= labs( (long)(_stepperData.stepsFromZero-lastSFZ) );
                 if ( _stepperData.rampState == rampStat::SPEEDDECEL ) {
                     // we are already reducing speed, compute nbr of steps to stop
                     uint16_t stepsToStop = _stepperData.stepRampLen + (_stepperData.stepsInRamp-_stepperData.stepRampLen)/_stepperData.deltaSteps;
@@ -443,7 +524,7 @@ void MoToStepper::_doSteps( long stepValue, bool absPos ) {
                 //digitalWrite(16,0);
                 //Schritte bis zum anhalten
                 // When moving to abs position, adjust stepCnt if there have been new steps
-                if ( absPos ) stepCnt += abs( _stepperData.stepsFromZero-lastSFZ );
+                if ( absPos ) stepCnt += labs( (long)(_stepperData.stepsFromZero-lastSFZ) );
                 uintxx_t stepsToStop = _stepperData.stepsInRamp+1;
                 if ( _stepperData.rampState == rampStat::SPEEDDECEL ) {
                     // we are already reducing speed, recompute nbr of steps to stop
@@ -476,6 +557,8 @@ void MoToStepper::_doSteps( long stepValue, bool absPos ) {
 					#ifndef IS_32BIT
                     _stepperData.aCycRemain     = 0;  
 					#endif
+                    _stepperData.startHold      = _prepared;    // wait for startAll() if prepared
+                    _prepared                   = false;
                    if ( _stepperData.enablePin != NO_STEPPER_ENABLE ) {
                         // start delaytime ( Stepper is enabled in ISR )
                         _stepperData.rampState      = rampStat::STARTING;
@@ -498,7 +581,7 @@ void MoToStepper::_doSteps( long stepValue, bool absPos ) {
         _noStepIRQ();
         //digitalWrite(16,0);
         // When moving to abs position, adjust stepCnt if there have been new steps
-        if ( absPos ) stepCnt = abs( stepValue + lastSFZ - _stepperData.stepsFromZero );
+        if ( absPos ) stepCnt = labs( (long)(stepValue + lastSFZ - _stepperData.stepsFromZero) );
         _stepperData.patternIxInc = patternIxInc;
         _stepperData.stepCnt = stepCnt;
         if ( stepValue == 0 ) {
@@ -519,6 +602,8 @@ void MoToStepper::_doSteps( long stepValue, bool absPos ) {
 				#ifndef IS_32BIT
 				_stepperData.aCycRemain     = 0; 
 				#endif
+				_stepperData.startHold      = _prepared;    // wait for startAll() if prepared
+				_prepared                   = false;
 				if ( _stepperData.enablePin != NO_STEPPER_ENABLE ) {
                         // start delaytime ( Stepper is enabled in ISR )
 					_stepperData.rampState      = rampStat::STARTING;
@@ -586,6 +671,7 @@ void MoToStepper::setZero(long zeroPoint) {
 void MoToStepper::setZero(long zeroPoint, long steps360) {
     if ( _stepperData.output == NO_OUTPUT ) return; // not attached
     stepsRev = steps360;
+    setRecip( _recipRev, stepsRev );
     setZero( zeroPoint );
 }
 
@@ -604,20 +690,26 @@ void MoToStepper::write( long angleArg, byte fact ) {
     negative =  ( angleArg < 0 ) ;
     DB_PRINT( "angleArg: %d",(int)angleArg ); //DB_PRINT( " getSFZ: ", getSFZ() );
     //Serial.print( "Write: " ); Serial.println( angleArg );
+    if ( fact != _recipFact ) {
+        setRecip( _recipAngle, 360L * fact );
+        _recipFact = fact;
+    }
     // full revolutions:
-    angle2steps = abs(angleArg) / (360L * fact ) * (long)stepsRev;
+    uint32_t absAngle = abs(angleArg);
+    uint32_t revs = recipDiv( _recipAngle, absAngle );
+    angle2steps = revs * stepsRev;
     // + remaining steps in last revolution ( with rounding )
-    angle2steps += (( abs(angleArg % (360L * fact) ) * (long)stepsRev ) + 180L*fact )/ ( 360L * fact)  ;
+    angle2steps += recipDiv( _recipAngle, ( absAngle - revs * 360L * fact ) * stepsRev + 180L*fact );
     //angle2steps =  ( (abs(angleArg) * (long)stepsRev*10) / ( 360L * fact) +5) /10 ;
     if ( negative ) angle2steps = -angle2steps;
-    _doSteps(angle2steps  - getSFZ(), 1 );
+    _doSteps( moveDistance( angle2steps - getSFZ() ), 1 );
 }
 
 void MoToStepper::writeSteps( long stepPos ) {
     // go to position stepPos steps away from zeropoint
     if ( _stepperData.output == NO_OUTPUT ) return; // not attached
     //digitalWrite(16,0);
-    _doSteps(stepPos  - getSFZ(), 1 );
+    _doSteps( moveDistance( stepPos - getSFZ() ), 1 );
 }
 
 long MoToStepper::read() {
@@ -628,11 +720,12 @@ long MoToStepper::read(byte factor) {
     // returns actual position as degree
     if ( _stepperData.output == NO_OUTPUT ) return 0; // not attached
 
-    long tmp = getSFZ();
+    long tmp = getSFZ();            // with MOTO_POS64 the angle is computed from the lower 32 bits
     bool negative;
     negative = ( tmp < 0 );
 	tmp = abs(tmp);
-	tmp = (tmp/stepsRev)*360L*factor + (( (tmp%stepsRev) * (3600L*factor) / stepsRev ) +5) / 10;
+	uint32_t revs = recipDiv( _recipRev, tmp );
+	tmp = revs*360L*factor + (recipDiv( _recipRev, (tmp - revs*stepsRev) * (3600L*factor) ) +5) / 10;
     if ( negative ) tmp = -tmp;
     return  tmp;
 }
@@ -644,6 +737,15 @@ long MoToStepper::readSteps()
     return  getSFZ();
 }
 
+#ifdef MOTO_POS64
+int64_t MoToStepper::readSteps64()
+{   // returns actual position as steps ( 64 bit )
+    if ( _stepperData.output == NO_OUTPUT ) return 0; // not attached
+
+    return  getSFZ();
+}
+#endif
+
 
 long MoToStepper::stepsToDo() { 
     // return remaining steps until target position
@@ -659,6 +761,7 @@ uint8_t MoToStepper::moving() {
     // return how much still to move (percentage)
     long tmp;
     if ( _stepperData.output == NO_OUTPUT ) return 0; // not attached
+    if ( _stepperData.endless ) return 100;     // the target of an endless rotation is never reached
     //Serial.print( _stepperData.stepCnt ); Serial.print(" "); 
     //Serial.println( _stepperData.aCycSteps );
     _noStepIRQ(); // disable Stepper interrupt, because (long)stepcnt is changed in TCR interrupt
@@ -675,6 +778,11 @@ uint8_t MoToStepper::moving() {
     return tmp ;
 }
 
+bool MoToStepper::rotating() {
+    // true while the stepper rotates endlessly ( started by rotate() )
+    return _stepperData.output != NO_OUTPUT && _stepperData.endless;
+}
+
 void MoToStepper::rotate(int8_t direction) {
 	// rotate endless ( not really, do maximum stepcount ;-)
     if ( _stepperData.output == NO_OUTPUT ) return; // not attached
@@ -686,6 +794,7 @@ void MoToStepper::rotate(int8_t direction) {
         } else {
             // start decelerating
             _noStepIRQ();
+            _stepperData.endless = false;
             switch ( _stepperData.rampState ) {
               case rampStat::RAMPACCEL:
               case rampStat::SPEEDDECEL:
@@ -708,10 +817,14 @@ void MoToStepper::rotate(int8_t direction) {
             _stepperData.stepCnt2 = 0;      // No reverse moving after stop
             _stepIRQ(); 
         }
-	} else if (direction > 0 ) { // ToDo: Grenzwerte sauber berechnen
-        doSteps(  2147483646L - _stepperData.stepRampLen );
 	} else {
-        doSteps( -2147483646L + _stepperData.stepRampLen);
+        // start with maximum stepcount, than the ISR stops counting down ( after reversing if necessary )
+        if (direction > 0 ) { // ToDo: Grenzwerte sauber berechnen
+            doSteps(  2147483646L - _stepperData.stepRampLen );
+        } else {
+            doSteps( -2147483646L + _stepperData.stepRampLen);
+        }
+        _stepperData.endless = true;
     }
     prDynData();
 }
@@ -720,6 +833,18 @@ void MoToStepper::stop() {
 	// immediate stop of the motor
     if ( _stepperData.output == NO_OUTPUT ) return; // not attached
     _noStepIRQ();
+    _stepperData.endless = false;
+    #ifndef ESP8266
+    _prepared = false;
+    if ( _stepperData.startHold ) {
+        // move is prepared but not yet started - simply discard it
+        _stepperData.startHold = false;
+        _stepperData.stepCnt = 0;
+        _stepperData.stepCnt2 = 0;
+        _stepperData.rampState = rampStat::STOPPED;
+        stepsToMove = 0;
+    } else
+    #endif
     if (  _stepperData.rampState >= rampStat::STARTING ) {
         // its moving, stopping with next pulse
         stepsToMove = 0;
@@ -38,6 +38,10 @@
 
 // #define CYCLETICS       (CYCLETIME*TICS_PER_MICROSECOND)
 constexpr uint16_t CYCLETICS   =  (CYCLETIME*TICS_PER_MICROSECOND);
+#ifndef ESP8266
+// prepare() and startAll() use one bit of an uint8_t mask per stepper
+static_assert( MAX_STEPPER <= 8, "MAX_STEPPER must not exceed 8 ( stepper mask of startAll )" );
+#endif
 #define MIN_START_CYCLES 4000/CYCLETIME  // 5ms min until first step if stepper is in stop
 #define MIN_STEPTIME    (CYCLETIME * MIN_STEP_CYCLE) 
 #ifdef IS_32BIT
@@ -50,6 +54,12 @@ constexpr uint16_t CYCLETICS   =  (CYCLETIME*TICS_PER_MICROSECOND);
     void ISR_Stepper(void);
 #endif
 
+#ifdef MOTO_POS64
+typedef int64_t stepPos_t;          // type of stepper position
+#else
+typedef long stepPos_t;
+#endif
+
 
 /////////////////////////////////////////////////////////////////////////////////
 // global stepper data ( used in ISR )
@@ -86,14 +96,20 @@ typedef struct stepperData_t {
 	uintxx_t cyctXramplen;        // precompiled  tCycSteps*(rampLen+RAMPOFFSET)
     volatile uintxx_t cycCnt;     // counting cycles until cycStep
 	uintxx_t cycDelay;            // delay time enable -> stepping
+    volatile uint8_t startHold;   // move is prepared, ISR waits for MoToStepper::startAll()
+    #ifdef MOTO_STATS
+    uint16_t lateSteps;           // nbr of steps that have been output later than scheduled
+    uint16_t maxLateTics;         // max delay of a step ( timer tics )
+    #endif
   #endif
   uintxx_t  stepRampLen;        // Length of ramp in steps
   uintxx_t  stepsInRamp;        // stepcounter within ramp ( counting from stop ( = 0 ): incrementing in startramp, decrementing in stopramp
   uintxx_t  deltaSteps;         // number of computed steps per real step in SPEEDDECEL
                                 // max value is stepRampLen
   rampStat rampState;        	// State of stepper: stopped, cruising, acceleration/deceleration ...
-  volatile long stepsFromZero;  // distance from last reference point ( always as steps in HALFSTEP mode )
+  volatile stepPos_t stepsFromZero;  // distance from last reference point ( always as steps in HALFSTEP mode )
                                 // in FULLSTEP mode this is twice the real step number
+  volatile uint8_t endless;     // rotate endless: stepCnt is not counted down ( except when reversing )
   uint8_t output  :6 ;             // PORTB(pin8-11), PORTD (pin4-7), SPI0,SPI1,SPI2,SPI3, SINGLE_PINS, A4988_PINS
   uint8_t delayActiv :1;        // enable delaytime is running
   uint8_t enable:1;             // true: enablePin=HIGH is active, false: enablePin=LOW is active
@@ -115,6 +131,11 @@ typedef struct stepperData_t {
   uint8_t lastPattern;             // only changed pins are updated ( is faster )
 } stepperData_t ;
 
+typedef struct { // division by an invariant divisor as multiplication ( is much faster on 8-bit processors )
+    uint32_t m;                     // multiplier
+    uint8_t  sh1, sh2;              // shifts
+} recip_t;
+
 typedef union { // used output channels as bit and uint8_t
       struct {
         uint8_t pin8_11 :1;
@@ -137,20 +158,36 @@ class MoToStepper
     stepperData_t _stepperData;      // Variables that are used in IRQ
     uint8_t _stepperIx;              // Objectnumber ( 0 ... MAX_STEPPER )
     long stepsRev;                   // steps per full rotation
+    recip_t _recipRev;               // reciprocal of stepsRev ( for read )
+    recip_t _recipAngle;             // reciprocal of 360*_recipFact ( for write )
+    uint8_t _recipFact;              // factor of last write(angle, factor)
     uintxx_t _stepSpeed10;      	// speed in steps/10sec as last set by user
     uintxx_t _lastRampLen ;         // last manually set ramplen
     uintxx_t _lastRampSpeed;        // speed when ramp was set manually
     long stepsToMove;               // from last point
     uint8_t stepMode;               // STEPDIR, FULLSTEP or HALFSTEP
-    
-    long getSFZ();                  // get step-distance from last reference point
-    long lastSFZ;                   // last read value ( for corrections in doSteps ) 
+    #ifndef ESP8266
+    bool _prepared;                 // next move is held back until startAll()
+    bool _ssValid;                  // arguments of last setSpeedSteps call are valid
+    uintxx_t _ssSpeed10;            // last speed10 argument of setSpeedSteps
+    intxx_t  _ssRampLen;            // last rampLen argument of setSpeedSteps
+    #ifndef IS_32BIT
+    uint32_t _rampSpeedFactor;      // speed10 per (stepsInRamp+RAMPOFFSET) in 1/256 ( for getSpeedSteps )
+    #endif
+    #endif
+
+    stepPos_t getSFZ();             // get step-distance from last reference point
+    stepPos_t lastSFZ;              // last read value ( for corrections in doSteps ) 
     void _doSteps(long count, bool absPos ); // rotate count steps. abs=true means it was called from write methods
 
     bool _chkRunning();             // check if stepper is running
+    #ifndef ESP8266
+    bool _retargetSpeed( uintxx_t speed10 ); // fast speed change while moving, keeps the slope of the ramp
+    #endif
     void initialize(long,uint8_t);
     uint16_t  _setRampValues();
     uint8_t attach(uint8_t outArg, uint8_t*  ); // internal attach function ( called by one of the public attach
+    friend class MoToStats;
   public:
     // don't allow copying and moving of Stepper objects
     MoToStepper &operator= (const MoToStepper & )    =delete;
@@ -167,6 +204,10 @@ class MoToStepper
         uint8_t attach( uint8_t,uint8_t,uint8_t,uint8_t); //single pins definition for output
         uint8_t attach(uint8_t outArg);    // stepMode defaults to halfstep
 		void attachEnable( uint16_t delay ); // enable for unipolar steppers with 4 pins
+        uint8_t prepare();          // the next move ( doSteps, write ... ) from standstill is not started until startAll()
+                                    // returns the bit of this stepper for the startAll mask ( 0 if stepper is moving )
+        static void startAll( uint8_t stepperMask = 0xff ); // start all prepared steppers in stepperMask with the same IRQ
+                                    // bit 0 is the first created stepper object
     #endif
     uint8_t attach( uint8_t stepP, uint8_t dirP); // Port for step and direction in STEPDIR mode
                                     // returns 0 on failure
@@ -194,10 +235,14 @@ class MoToStepper
     long stepsToDo();               // remaining steps until target position
     uint8_t moving();               // returns the remaining way to the position last set with write() in
                                     // in percentage. '0' means, that the target positio is reached
-                                    // 255 means the motor is rotating endlessly
+                                    // ( always 100 while rotating endlessly )
+    bool rotating();                // true while the motor is rotating endlessly ( started by rotate() )
     long read();                    // actual angle from zeropoint 
     long read(byte factor);         // actual angle from zeropoint ( in fractions)
     long readSteps();               // actual distance to zeropoint in steps
+    #ifdef MOTO_POS64
+    int64_t readSteps64();          // actual distance to zeropoint in steps, without overflow in endless rotation
+    #endif
     uint8_t attached();
     void prDynData();             // print actual Stepperdata
     
@@ -0,0 +1,94 @@
+/*
+  MobaTools.h - a library for model railroaders
+  Author: fpm, fpm@mnet-mail.de
+  Copyright (c) 2020 All right reserved.
+
+  Functions for the ISR event trace of MobaTools
+*/
+#include <MobaTools.h>
+#include <utilities/MoToDbg.h>
+
+#ifdef MOTO_TRACE
+traceEvent_t traceBuf[MOTO_TRACE];
+volatile uint16_t traceWrCnt;
+static uint16_t traceRdCnt;             // free running count of read events
+static uint16_t traceLost;
+
+static uint16_t getWrCnt() {
+    // traceWrCnt is changed in the ISRs, on AVR a 16 bit value must be read with interrupts disabled
+    #ifdef __AVR__
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t wrCnt = traceWrCnt;
+    SREG = sreg;
+    return wrCnt;
+    #else
+    return traceWrCnt;
+    #endif
+}
+#endif
+
+uint8_t MoToTrace::available() {
+    #ifdef MOTO_TRACE
+    uint16_t unread = getWrCnt() - traceRdCnt;
+    return unread > MOTO_TRACE ? MOTO_TRACE : unread;
+    #else
+    return 0;
+    #endif
+}
+
+bool MoToTrace::read( traceEvent_t &event ) {
+    #ifdef MOTO_TRACE
+    uint16_t wrCnt;
+    while ( ( wrCnt = getWrCnt() ) != traceRdCnt ) {
+        uint16_t unread = wrCnt - traceRdCnt;
+        if ( unread > MOTO_TRACE ) {
+            // the ISRs have overwritten the oldest events
+            uint16_t lost = unread - MOTO_TRACE;
+            traceLost = traceLost > 0xffff - lost ? 0xffff : traceLost + lost;   // saturating
+            traceRdCnt += unread - MOTO_TRACE;
+        }
+        event = traceBuf[ traceRdCnt & (MOTO_TRACE-1) ];
+        // if the entry was overwritten while copying, try again with the next one
+        if ( (uint16_t)(getWrCnt() - traceRdCnt) <= MOTO_TRACE ) {
+            traceRdCnt++;
+            return true;
+        }
+    }
+    #else
+    (void)event;
+    #endif
+    return false;
+}
+
+uint16_t MoToTrace::lost() {
+    #ifdef MOTO_TRACE
+    return traceLost;
+    #else
+    return 0;
+    #endif
+}
+
+void MoToTrace::clear() {
+    #ifdef MOTO_TRACE
+    traceRdCnt = getWrCnt();
+    traceLost = 0;
+    #endif
+}
+
+void MoToTrace::add( uint8_t id, uint8_t ix, uint16_t value ) {
+    TRACE_EVENT( id, ix, value );
+    #ifndef MOTO_TRACE
+    (void)id; (void)ix; (void)value;
+    #endif
+}
+
+void MoToTrace::dump( Print &out ) {
+    traceEvent_t event;
+    while ( read( event ) ) {
+        out.print( event.time ); out.print( ' ' );
+        out.print( event.id ); out.print( ' ' );
+        out.print( event.ix ); out.print( ' ' );
+        out.println( event.value );
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef MOTOTRACE_H
+#define MOTOTRACE_H
+/*
+  MobaTools.h - a library for model railroaders
+  Author: fpm, fpm@mnet-mail.de
+  Copyright (c) 2020 All right reserved.
+
+  Definitions and declarations for the ISR event trace of MobaTools
+  The trace is only compiled if MOTO_TRACE is defined in MobaTools.h. The ISRs write binary events
+  into a ring buffer ( the oldest events are overwritten ), the sketch reads them in loop().
+*/
+
+// event ids
+#define TR_STEPIRQ      1   // start of stepper/softled IRQ, value = cycles since last IRQ
+#define TR_NEXTIRQ      2   // end of stepper/softled IRQ, value = cycles until next IRQ
+#define TR_STEP         3   // step pulse, ix = stepper ( in order of creation ), value = actual cycles per step
+#define TR_SERVO        4   // start of servo pulse, ix = servo, value = pulse length ( timer tics )
+#define TR_SOFTLED      5   // softleds are processed in this IRQ, value = cycles within PWM cycle
+#define TR_USER       128   // ids from 128 on are free for the sketch
+
+typedef struct {
+    uint16_t time;      // micros() at the event ( lower 16 bits )
+    uint8_t  id;        // event id ( TR_xxx )
+    uint8_t  ix;        // index of stepper, servo ...
+    uint16_t value;     // event specific value
+} traceEvent_t;
+
+#ifdef MOTO_TRACE
+static_assert( MOTO_TRACE >= 4 && MOTO_TRACE <= 128 && (MOTO_TRACE & (MOTO_TRACE-1)) == 0,
+                "MOTO_TRACE must be a power of 2 between 4 and 128" );
+extern traceEvent_t traceBuf[MOTO_TRACE];
+extern volatile uint16_t traceWrCnt;    // free running count of written events ( 16 bit: up to 65535 unread
+                                        // events are counted correctly in MoToTrace::lost() )
+
+static inline __attribute__((__always_inline__)) void traceEvent( uint8_t id, uint8_t ix, uint16_t value ) {
+    // may be called from any ISR ( and from loop() )
+    uint16_t wrIx;
+    #ifdef __AVR__
+    uint8_t sreg = SREG;
+    cli();
+    wrIx = traceWrCnt++;
+    SREG = sreg;
+    #else
+    wrIx = __atomic_fetch_add( &traceWrCnt, 1, __ATOMIC_RELAXED );
+    #endif
+    traceEvent_t *evP = &traceBuf[ wrIx & (MOTO_TRACE-1) ];
+    evP->time = micros();
+    evP->id = id;
+    evP->ix = ix;
+    evP->value = value;
+}
+#define TRACE_EVENT( id, ix, value )  traceEvent( id, ix, value )
+#else
+#define TRACE_EVENT( id, ix, value )
+#endif
+
+class MoToTrace
+{ // read the ISR event trace
+  public:
+    static uint8_t available();             // nbr of events not yet read
+    static bool read( traceEvent_t &event ); // get oldest unread event, false if there is none
+    static uint16_t lost();                 // nbr of events that have been overwritten before they were read ( max. 65535 )
+    static void clear();                    // discard all unread events
+    static void add( uint8_t id, uint8_t ix, uint16_t value ); // write an own event ( id >= TR_USER )
+    static void dump( Print &out );         // print all unread events ( 'time id ix value' per line )
+};
+
+#endif